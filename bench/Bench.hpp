@@ -0,0 +1,26 @@
+#pragma once
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+
+/*
+ * Minimal timing helpers shared by the benchmarks
+ */
+
+// keeps benchmarked results from being optimized away
+inline volatile std::uint64_t g_sink;
+
+/*
+ * Run fn repeat times and return the fastest run in seconds
+ */
+template <typename F>
+double BestOf(const int &repeat, F &&fn) {
+	double best { 1e300 };
+	for (int i = 0; i < repeat; ++i) {
+		auto start { std::chrono::steady_clock::now() };
+		fn();
+		std::chrono::duration<double> elapsed { std::chrono::steady_clock::now() - start };
+		best = std::min(best, elapsed.count());
+	}
+	return best;
+}
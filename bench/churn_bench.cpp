@@ -0,0 +1,102 @@
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+#if defined(__unix__) || defined(__APPLE__)
+#include <unistd.h>
+#endif
+#include "HashTable.hpp"
+#include "Bench.hpp"
+
+/*
+ * Sustained insert/remove churn against HashTable
+ *
+ * usage: csc300_churn_bench [live courses] [rounds]
+ *
+ * Each round replaces every live course, one remove and one insert of a
+ * never seen number at a time, like term to term catalog updates. Then
+ * the table is blown up to 10x and churned back down. Slot count and
+ * resident memory should track the live size, not the history.
+ */
+
+namespace {
+	// resident set size in MiB, from /proc where available
+	double residentMiB() {
+#if defined(__unix__) || defined(__APPLE__)
+		std::ifstream statm { "/proc/self/statm" };
+		std::size_t pages { }, resident { };
+		if (!(statm >> pages >> resident)) {
+			return 0;
+		}
+		return resident * static_cast<double>(sysconf(_SC_PAGESIZE)) / (1 << 20);
+#else
+		return 0;
+#endif
+	}
+
+	std::string number(const std::size_t &i) {
+		return "CSCI" + std::to_string(1000000 + i);
+	}
+}
+
+int main(int argc, char *argv[]) {
+	std::size_t live { argc > 1 ? std::stoul(argv[1]) : 100000 };
+	std::size_t rounds { argc > 2 ? std::stoul(argv[2]) : 10 };
+	HashTable table;
+	std::vector<std::size_t> ids; // numbers currently in the table
+	std::size_t next { };
+	for (; next < live; ++next) {
+		table.insert(Course { number(next), "Synthetic course", { } });
+		ids.push_back(next);
+	}
+	std::mt19937_64 random { 42 };
+	auto report = [&](const std::string &phase, double ns_per_op) {
+		std::cout << std::left << std::setw(14) << phase << std::setw(10) << table.size() << std::setw(10) << table.bucket_count()
+			<< std::fixed << std::setprecision(1) << std::setw(12) << residentMiB() << ns_per_op << std::endl;
+	};
+	std::cout << std::left << std::setw(14) << "phase" << std::setw(10) << "courses" << std::setw(10) << "slots"
+		<< std::setw(12) << "rss MiB" << "ns/op" << std::endl;
+	report("loaded", 0);
+	// replace a random live course with a new one
+	auto churn = [&](std::size_t ops) {
+		auto start { std::chrono::steady_clock::now() };
+		for (std::size_t op = 0; op < ops; ++op) {
+			std::size_t victim { random() % ids.size() };
+			table.remove(number(ids[victim]));
+			ids[victim] = next;
+			table.insert(Course { number(next++), "Synthetic course", { } });
+		}
+		std::chrono::duration<double, std::nano> elapsed { std::chrono::steady_clock::now() - start };
+		return elapsed.count() / (2 * ops);
+	};
+	for (std::size_t round = 1; round <= rounds; ++round) {
+		report("churn " + std::to_string(round), churn(live));
+	}
+	// spike to 10x, then remove back down to the original live size
+	for (std::size_t i = 0; i < live * 9; ++i, ++next) {
+		table.insert(Course { number(next), "Synthetic course", { } });
+		ids.push_back(next);
+	}
+	report("spike", 0);
+	auto start { std::chrono::steady_clock::now() };
+	std::shuffle(ids.begin(), ids.end(), random);
+	while (ids.size() > live) {
+		table.remove(number(ids.back()));
+		ids.pop_back();
+	}
+	ids.shrink_to_fit();
+	std::chrono::duration<double, std::nano> elapsed { std::chrono::steady_clock::now() - start };
+	report("drained", elapsed.count() / (live * 9));
+	report("churn after", churn(live));
+	// every live course must still be found
+	for (std::size_t id : ids) {
+		if (!table.contains(number(id))) {
+			std::cout << "lost course " << number(id) << std::endl;
+			return -1;
+		}
+	}
+	g_sink = table.size();
+}
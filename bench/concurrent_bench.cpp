@@ -0,0 +1,90 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+#include "ConcurrentHashTable.hpp"
+#include "HashTable.hpp"
+#include "Bench.hpp"
+
+/*
+ * Lookup throughput with concurrent readers and a trickle of writes:
+ * one global mutex around a HashTable against ConcurrentHashTable
+ *
+ * usage: csc300_concurrent_bench [courses] [max reader threads]
+ */
+
+namespace {
+	constexpr std::chrono::milliseconds RUN_TIME { 300 };
+	constexpr std::chrono::milliseconds WRITE_EVERY { 1 };
+
+	// run readers threads calling read(key) and one writer calling write(i), return lookups per second
+	template <typename Read, typename Write>
+	double run(const unsigned int &readers, const std::vector<std::string> &keys, Read &&read, Write &&write) {
+		std::atomic<bool> stop { false };
+		std::atomic<std::uint64_t> lookups { };
+		std::vector<std::jthread> threads;
+		for (unsigned int t = 0; t < readers; ++t) {
+			threads.emplace_back([&, t]() {
+				std::uint64_t done { }, found { };
+				for (std::size_t i { t * 7919u }; !stop.load(std::memory_order_relaxed); ++done) {
+					found += read(keys[i++ % keys.size()]);
+				}
+				lookups += done;
+				g_sink = found;
+			});
+		}
+		threads.emplace_back([&]() {
+			for (std::size_t i = 0; !stop.load(std::memory_order_relaxed); ++i) {
+				write(i);
+				std::this_thread::sleep_for(WRITE_EVERY);
+			}
+		});
+		std::this_thread::sleep_for(RUN_TIME);
+		stop = true;
+		threads.clear();
+		return lookups.load() / std::chrono::duration<double>(RUN_TIME).count();
+	}
+}
+
+int main(int argc, char *argv[]) {
+	std::size_t courses { argc > 1 ? std::stoul(argv[1]) : 100000 };
+	unsigned int max_readers { argc > 2 ? static_cast<unsigned int>(std::stoul(argv[2])) : std::max(1u, std::thread::hardware_concurrency()) };
+	std::vector<std::string> keys;
+	HashTable table;
+	for (std::size_t i = 0; i < courses; ++i) {
+		keys.push_back("CSCI" + std::to_string(100000 + i));
+		table.insert(Course { keys.back(), "Synthetic course", { } });
+	}
+	std::shuffle(keys.begin(), keys.end(), std::mt19937 { 42 });
+	HashTable locked_table { table };
+	std::mutex lock;
+	ConcurrentHashTable shared { std::move(table) };
+	auto updated = [&](std::size_t i) {
+		return Course { keys[i % keys.size()], "Updated course " + std::to_string(i), { } };
+	};
+	std::cout << courses << " courses, " << shared.shard_count() << " shards, one write per " << WRITE_EVERY.count() << " ms" << std::endl;
+	std::cout << std::left << std::setw(10) << "readers" << std::setw(22) << "mutex M lookups/s" << "concurrent M lookups/s" << std::endl;
+	for (unsigned int readers = 1; readers <= max_readers; readers *= 2) {
+		double with_mutex { run(readers, keys, [&](const std::string &key) {
+			std::lock_guard<std::mutex> guard { lock };
+			return locked_table.contains(key);
+		}, [&](std::size_t i) {
+			Course course { updated(i) };
+			std::lock_guard<std::mutex> guard { lock };
+			locked_table.insert(std::move(course));
+		}) };
+		double concurrent { run(readers, keys, [&](const std::string &key) {
+			return shared.contains(key);
+		}, [&](std::size_t i) {
+			shared.insert(updated(i));
+		}) };
+		std::cout << std::left << std::setw(10) << readers << std::fixed << std::setprecision(2)
+			<< std::setw(22) << with_mutex / 1e6 << concurrent / 1e6 << std::endl;
+	}
+}
@@ -0,0 +1,92 @@
+#include <charconv>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include "CatalogGenerator.hpp"
+
+/*
+ * Write a synthetic course catalog for load and benchmark runs
+ *
+ * usage: csc300_generate [options] [output csv, - for stdout]
+ *   --courses=N        number of courses, default 100000
+ *   --departments=N    number of departments, default 64
+ *   --skew=X           Zipf exponent of department sizes, default 1, 0 for equal
+ *   --fan-out=N        most prerequisites per course, default 3
+ *   --depth=N          prerequisite levels per department, default 6
+ *   --order=O          shuffled, sorted or reversed rows, default shuffled
+ *   --keys=K           catalog or colliding course numbers, default catalog
+ *   --seed=N           default 42
+ */
+
+namespace {
+	// whole string as a number, false if it is not one
+	template <typename T>
+	bool parse(std::string_view text, T &value) {
+		auto [end, error] { std::from_chars(text.data(), text.data() + text.size(), value) };
+		return error == std::errc { } && end == text.data() + text.size();
+	}
+}
+
+int main(int argc, char *argv[]) {
+	GeneratorOptions options;
+	std::string path { "-" };
+	for (int i = 1; i < argc; ++i) {
+		std::string_view arg { argv[i] };
+		std::size_t equals { arg.find('=') };
+		std::string_view name { arg.substr(0, equals) };
+		std::string_view value { equals == std::string_view::npos ? std::string_view { } : arg.substr(equals + 1) };
+		bool ok { true };
+		if (name == "--courses") {
+			ok = parse(value, options.courses);
+		} else if (name == "--departments") {
+			ok = parse(value, options.departments);
+		} else if (name == "--skew") {
+			ok = parse(value, options.skew);
+		} else if (name == "--fan-out") {
+			ok = parse(value, options.fan_out);
+		} else if (name == "--depth") {
+			ok = parse(value, options.depth);
+		} else if (name == "--order") {
+			ok = ParseRowOrder(value, options.order);
+		} else if (name == "--keys") {
+			ok = ParseKeyPattern(value, options.keys);
+		} else if (name == "--seed") {
+			ok = parse(value, options.seed);
+		} else if (name.starts_with("--")) {
+			ok = false;
+		} else {
+			path = arg;
+		}
+		if (!ok) {
+			std::cerr << "Unknown option or value: " << arg << std::endl;
+			return -1;
+		}
+	}
+	std::ofstream file;
+	if (path != "-") {
+		file.open(path, std::ios::binary);
+		if (!file) {
+			std::cerr << "Could not open file: " << path << std::endl;
+			return -1;
+		}
+	}
+	std::ostream &out { path == "-" ? std::cout : file };
+	auto start { std::chrono::steady_clock::now() };
+	std::uint64_t rows { GenerateCatalog(out, options) };
+	out.flush();
+	std::chrono::duration<double> elapsed { std::chrono::steady_clock::now() - start };
+	if (!out) {
+		std::cerr << "Could not write " << path << " after " << rows << " rows" << std::endl;
+		return -1;
+	}
+	double mib { path == "-" ? 0 : static_cast<double>(file.tellp()) / (1 << 20) };
+	std::cerr << rows << " courses";
+	if (path != "-") {
+		std::cerr << ", " << std::fixed << std::setprecision(1) << mib << " MiB in " << elapsed.count() << " s, "
+			<< mib / elapsed.count() << " MiB/s";
+	}
+	std::cerr << std::endl;
+}
@@ -0,0 +1,78 @@
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <unordered_set>
+#include <vector>
+#include "HashTable.hpp"
+#include "Bench.hpp"
+
+/*
+ * Report collision counts of each hash policy over the course numbers of a CSV
+ *
+ * usage: csc300_hash_bench [path to csv]
+ */
+
+// count keys that land in an occupied home slot for a table of the given size
+template <typename Hash>
+void report(const char *name, const std::vector<std::string> &keys) {
+	Hash hasher;
+	std::vector<unsigned int> hashes;
+	for (const std::string &key : keys) {
+		std::uint64_t h { hasher(key) };
+		hashes.push_back(static_cast<unsigned int>(h ^ (h >> 32)));
+	}
+	// same sizing rule as HashTable(t_size)
+	unsigned int slots { 8 };
+	while (slots * 0.875 < keys.size()) {
+		slots <<= 1;
+	}
+	std::vector<unsigned int> buckets(slots);
+	unsigned int home_collisions { }, longest { };
+	for (unsigned int h : hashes) {
+		if (buckets[h & (slots - 1)]++ > 0) {
+			++home_collisions;
+		}
+		longest = std::max(longest, buckets[h & (slots - 1)]);
+	}
+	std::unordered_set<unsigned int> distinct(hashes.begin(), hashes.end());
+	// time hashing every key, repeated to get a stable number
+	constexpr int REPEAT { 1000 };
+	std::uint64_t sink { };
+	auto start { std::chrono::steady_clock::now() };
+	for (int r = 0; r < REPEAT; ++r) {
+		for (const std::string &key : keys) {
+			sink += hasher(key);
+		}
+	}
+	std::chrono::duration<double, std::nano> elapsed { std::chrono::steady_clock::now() - start };
+	g_sink = sink;
+	std::cout << std::left << std::setw(18) << name
+		<< std::setw(8) << slots
+		<< std::setw(18) << home_collisions
+		<< std::setw(16) << longest
+		<< std::setw(18) << keys.size() - distinct.size()
+		<< elapsed.count() / (REPEAT * keys.size()) << std::endl;
+}
+
+int main(int argc, char *argv[]) {
+	std::string path { argc > 1 ? argv[1] : "./CS 300 ABCU_Advising_Program_Input.csv" };
+	HashTable table;
+	table.loadFromCSV(path);
+	std::vector<std::string> keys;
+	for (const Course &course : table.toVector()) {
+		keys.push_back(course.number);
+	}
+	if (keys.empty()) {
+		std::cout << "No courses loaded from file: " << path << std::endl;
+		return -1;
+	}
+	std::cout << keys.size() << " course numbers from " << path << std::endl;
+	std::cout << std::left << std::setw(18) << "policy" << std::setw(8) << "slots"
+		<< std::setw(18) << "home collisions" << std::setw(16) << "longest bucket"
+		<< std::setw(18) << "32-bit collisions" << "ns/hash" << std::endl;
+	report<WyHash>("WyHash", keys);
+	report<Fnv1aHash>("Fnv1aHash", keys);
+	report<Polynomial31Hash>("Polynomial31Hash", keys);
+}
@@ -0,0 +1,74 @@
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "HashTable.hpp"
+#include "Bench.hpp"
+
+/*
+ * Compare HashTable::find one key at a time against search_batch
+ *
+ * usage: csc300_lookup_bench [courses] [lookups]
+ *
+ * Builds a synthetic catalog large enough to miss the caches, then looks
+ * up a random mix of present (7 in 8) and missing course numbers.
+ */
+
+int main(int argc, char *argv[]) {
+	std::size_t courses { argc > 1 ? std::stoul(argv[1]) : 1 << 21 };
+	std::size_t lookups { argc > 2 ? std::stoul(argv[2]) : 1 << 20 };
+	const char *DEPARTMENTS[] { "CSCI", "MATH", "PHYS", "CHEM", "BIOL", "ENGL", "HIST", "ECON" };
+	auto number = [&](std::size_t i) {
+		return DEPARTMENTS[i % 8] + std::to_string(100000 + i / 8);
+	};
+	HashTable table;
+	table.reserve(courses);
+	for (std::size_t i = 0; i < courses; ++i) {
+		table.insert(Course { number(i), "Synthetic course " + std::to_string(i), { } });
+	}
+	std::mt19937_64 random { 42 };
+	std::vector<std::string> keys;
+	keys.reserve(lookups);
+	for (std::size_t i = 0; i < lookups; ++i) {
+		std::size_t pick { random() % courses };
+		keys.push_back(random() % 8 == 0 ? "NONE" + std::to_string(pick) : number(pick));
+	}
+	std::vector<std::string_view> views { keys.begin(), keys.end() };
+	std::vector<const Course *> results(views.size());
+	std::cout << courses << " courses, " << lookups << " lookups" << std::endl;
+	const int REPEAT { 5 };
+	auto report = [&](const std::string &name, double seconds) {
+		std::cout << std::left << std::setw(24) << name << std::fixed << std::setprecision(1)
+			<< seconds * 1e9 / lookups << " ns/lookup  "
+			<< lookups / seconds / 1e6 << " M lookups/s" << std::endl;
+	};
+	auto checksum = [&]() {
+		std::uint64_t found { };
+		for (const Course *course : results) {
+			found += course != nullptr ? course->title.size() : 1;
+		}
+		return found;
+	};
+	report("find loop", BestOf(REPEAT, [&]() {
+		for (std::size_t i = 0; i < views.size(); ++i) {
+			results[i] = table.find(views[i]);
+		}
+	}));
+	std::uint64_t expected { checksum() };
+	// requests come in as degree plans of a few hundred courses
+	for (std::size_t batch : { std::size_t { 16 }, std::size_t { 256 }, lookups }) {
+		report("search_batch " + std::to_string(batch), BestOf(REPEAT, [&]() {
+			for (std::size_t first = 0; first < views.size(); first += batch) {
+				std::size_t count { std::min(batch, views.size() - first) };
+				table.search_batch(std::span { views }.subspan(first, count), std::span { results }.subspan(first, count));
+			}
+		}));
+		if (checksum() != expected) {
+			std::cout << "search_batch results differ from find" << std::endl;
+			return -1;
+		}
+	}
+	g_sink = expected;
+}
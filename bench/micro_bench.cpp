@@ -0,0 +1,499 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <optional>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "CatalogDelta.hpp"
+#include "CatalogGenerator.hpp"
+#include "CourseColumns.hpp"
+#include "CsvLoader.hpp"
+#include "FrozenTable.hpp"
+#include "Hash.hpp"
+#include "HashTable.hpp"
+#include "HotCatalog.hpp"
+#include "LazyCatalog.hpp"
+#include "PrerequisiteGraph.hpp"
+#include "Sort.hpp"
+#include "Bench.hpp"
+
+/*
+ * Microbenchmarks of the core catalog operations
+ *
+ * usage: csc300_bench [--json] [--max=courses] [--filter=text] [path to csv]
+ *
+ * Every benchmark runs on the bundled csv, or the one given, and on
+ * CatalogGenerator catalogs of 1k, 10k, 100k and 1M courses; --max=10000000
+ * adds 10M. Results are the best of several runs in nanoseconds per
+ * operation: per course for whole catalog operations, per key for
+ * lookups. Loads also report heap allocations per course, counted by
+ * the operator new below. --json prints them as one JSON document to
+ * track regressions, with progress on stderr. --filter runs only
+ * benchmarks whose name contains the text.
+ */
+
+// every heap allocation of the process, for the allocations per load
+std::atomic<std::size_t> g_allocations;
+
+namespace {
+	void *countedAllocate(const std::size_t &size) {
+		g_allocations.fetch_add(1, std::memory_order_relaxed);
+		if (void *memory { std::malloc(size == 0 ? 1 : size) }) {
+			return memory;
+		}
+		throw std::bad_alloc { };
+	}
+}
+
+void *operator new(std::size_t size) {
+	return countedAllocate(size);
+}
+
+void *operator new[](std::size_t size) {
+	return countedAllocate(size);
+}
+
+void operator delete(void *memory) noexcept {
+	std::free(memory);
+}
+
+void operator delete[](void *memory) noexcept {
+	std::free(memory);
+}
+
+void operator delete(void *memory, std::size_t) noexcept {
+	std::free(memory);
+}
+
+void operator delete[](void *memory, std::size_t) noexcept {
+	std::free(memory);
+}
+
+namespace {
+	struct Result {
+		std::string name;
+		std::string catalog;
+		std::size_t courses;
+		int runs;
+		double ns_per_op;
+		double allocations_per_op { -1 }; // negative when not counted
+	};
+
+	struct Catalog {
+		std::string name;
+		std::vector<Course> courses;
+		std::string csv_path; // the same courses as a csv file
+	};
+
+	// best of runs, with setup() before each run left out of the timing
+	template <typename Setup, typename F>
+	double BestOfWithSetup(const int &runs, Setup &&setup, F &&fn) {
+		double best { 1e300 };
+		for (int i = 0; i < runs; ++i) {
+			setup();
+			best = std::min(best, BestOf(1, fn));
+		}
+		return best;
+	}
+
+	// a generated catalog, written as a csv and loaded back
+	Catalog synthetic(const std::size_t &count) {
+		Catalog catalog { std::to_string(count) + " synthetic", { }, { } };
+		catalog.csv_path = (std::filesystem::temp_directory_path() / ("csc300_bench_" + std::to_string(count) + ".csv")).string();
+		{
+			std::ofstream csv { catalog.csv_path, std::ios::binary };
+			GenerateCatalog(csv, GeneratorOptions { .courses = count });
+		}
+		// loadFromCSV expects the bundled file's trailing delimiters, so
+		// read the generated rows with the validating loader
+		catalog.courses = LoadCatalog(catalog.csv_path).table.toVector();
+		return catalog;
+	}
+
+	// print each result to out as it is measured, and collect it
+	void run(const Catalog &catalog, const std::string &filter, std::ostream &out, std::vector<Result> &results) {
+		const std::size_t n { catalog.courses.size() };
+		// more runs for small catalogs, where one run is too short to time well
+		const int runs { static_cast<int>(std::clamp<std::size_t>(2000000 / std::max<std::size_t>(n, 1), 3, 25)) };
+		auto measure = [&](const std::string &name, const std::size_t &ops, auto &&time) {
+			if (name.find(filter) == std::string::npos) {
+				return;
+			}
+			double seconds { time() };
+			results.push_back(Result { name, catalog.name, n, runs, seconds * 1e9 / std::max<std::size_t>(ops, 1) });
+			out << "  " << std::left << std::setw(44) << name << std::fixed << std::setprecision(1) << results.back().ns_per_op << " ns/op" << std::endl;
+		};
+		// measure, then count the allocations of one more call to fn
+		auto measureLoad = [&](const std::string &name, const std::size_t &ops, auto &&fn) {
+			if (name.find(filter) == std::string::npos) {
+				return;
+			}
+			double seconds { BestOf(std::min(runs, 5), fn) };
+			std::size_t before { g_allocations.load() };
+			fn();
+			double allocations { static_cast<double>(g_allocations.load() - before) / std::max<std::size_t>(ops, 1) };
+			results.push_back(Result { name, catalog.name, n, runs, seconds * 1e9 / std::max<std::size_t>(ops, 1), allocations });
+			out << "  " << std::left << std::setw(44) << name << std::fixed << std::setprecision(1) << results.back().ns_per_op << " ns/op, "
+				<< std::setprecision(2) << allocations << " allocations/op" << std::endl;
+		};
+		out << catalog.name << ", " << n << " courses" << std::endl;
+		std::vector<std::string> keys;
+		for (const Course &course : catalog.courses) {
+			keys.push_back(course.number);
+		}
+		std::shuffle(keys.begin(), keys.end(), std::mt19937 { 42 });
+		auto hash = [&](auto hasher) {
+			return [&, hasher]() {
+				return BestOf(runs, [&]() {
+					std::uint64_t sum { };
+					for (const std::string &key : keys) {
+						sum += hasher(key);
+					}
+					g_sink = sum;
+				});
+			};
+		};
+		measure("hash/WyHash", n, hash(WyHash { }));
+		measure("hash/Fnv1aHash", n, hash(Fnv1aHash { }));
+		measure("hash/Polynomial31Hash", n, hash(Polynomial31Hash { }));
+		HashTable<> table;
+		measure("HashTable::insert", n, [&]() {
+			return BestOfWithSetup(runs, [&]() {
+				table = HashTable<> { };
+			}, [&]() {
+				for (const Course &course : catalog.courses) {
+					table.insert(course);
+				}
+			});
+		});
+		if (table.size() == 0) {
+			for (const Course &course : catalog.courses) {
+				table.insert(course);
+			}
+		}
+		measure("HashTable::search", n, [&]() {
+			return BestOf(runs, [&]() {
+				std::uint64_t found { };
+				for (const std::string &key : keys) {
+					found += table.search(key).title.size();
+				}
+				g_sink = found;
+			});
+		});
+		measure("HashTable::find", n, [&]() {
+			return BestOf(runs, [&]() {
+				std::uint64_t found { };
+				for (const std::string &key : keys) {
+					found += table.find(key) != nullptr;
+				}
+				g_sink = found;
+			});
+		});
+		FrozenTable<> frozen;
+		measure("Freeze", n, [&]() {
+			return BestOf(std::min(runs, 5), [&]() {
+				g_sink = Freeze(table, frozen);
+			});
+		});
+		if (frozen.size() == 0) {
+			Freeze(table, frozen);
+		}
+		if (frozen.size() == n) {
+			measure("FrozenTable::find", n, [&]() {
+				return BestOf(runs, [&]() {
+					std::uint64_t found { };
+					for (const std::string &key : keys) {
+						found += frozen.find(key) != nullptr;
+					}
+					g_sink = found;
+				});
+			});
+		}
+		// the same lookups with keys packed into CourseKeys, when they all fit
+		HashTable<WyHash, KeyedCourse> keyed;
+		for (const Course &course : catalog.courses) {
+			KeyedCourse packed;
+			if (!ToKeyedCourse(course, packed)) {
+				keyed = { };
+				break;
+			}
+			keyed.insert(std::move(packed));
+		}
+		if (keyed.size() == n) {
+			measure("HashTable<CourseKey>::find", n, [&]() {
+				return BestOf(runs, [&]() {
+					std::uint64_t found { };
+					for (const std::string &key : keys) {
+						found += keyed.find(key) != nullptr;
+					}
+					g_sink = found;
+				});
+			});
+			std::vector<CourseKey> packed_keys { keys.begin(), keys.end() };
+			measure("HashTable<CourseKey>::find(key)", n, [&]() {
+				return BestOf(runs, [&]() {
+					std::uint64_t found { };
+					for (const CourseKey &key : packed_keys) {
+						found += keyed.find(key) != nullptr;
+					}
+					g_sink = found;
+				});
+			});
+			measure("HashTable<CourseKey>::remove", n, [&]() {
+				HashTable<WyHash, KeyedCourse> scratch;
+				return BestOfWithSetup(runs, [&]() {
+					scratch = keyed;
+				}, [&]() {
+					for (const std::string &key : keys) {
+						scratch.remove(key);
+					}
+				});
+			});
+		}
+		measure("HashTable::toVector", n, [&]() {
+			return BestOf(runs, [&]() {
+				g_sink = table.toVector().size();
+			});
+		});
+		measure("HashTable::remove", n, [&]() {
+			HashTable<> scratch;
+			return BestOfWithSetup(runs, [&]() {
+				scratch = table;
+			}, [&]() {
+				for (const std::string &key : keys) {
+					scratch.remove(key);
+				}
+			});
+		});
+		measure("HashTable::loadFromCSV", n, [&]() {
+			return BestOfWithSetup(runs, [&]() {
+				table = HashTable<> { };
+			}, [&]() {
+				table.loadFromCSV(catalog.csv_path);
+			});
+		});
+		measureLoad("LoadCatalog", n, [&]() {
+			g_sink = LoadCatalog(catalog.csv_path).table.size();
+		});
+		measureLoad("LoadCourseArena", n, [&]() {
+			g_sink = LoadCourseArena(catalog.csv_path).table.size();
+		});
+		// freeing a loaded catalog: a free per string and vector, or per arena block
+		std::optional<LoadResult<HashTable<>>> loaded_table;
+		measure("LoadCatalog/teardown", n, [&]() {
+			return BestOfWithSetup(std::min(runs, 5), [&]() {
+				loaded_table = LoadCatalog(catalog.csv_path);
+			}, [&]() {
+				loaded_table.reset();
+			});
+		});
+		std::optional<LoadResult<CourseArena>> loaded_arena;
+		measure("LoadCourseArena/teardown", n, [&]() {
+			return BestOfWithSetup(std::min(runs, 5), [&]() {
+				loaded_arena = LoadCourseArena(catalog.csv_path);
+			}, [&]() {
+				loaded_arena.reset();
+			});
+		});
+		// a term's worth of changes against reloading the catalog for them:
+		// the first delta edits 12 courses and adds 4, the second edits
+		// the same 12 and removes the 4 again, so the pair can repeat
+		measure("LoadCatalog and BuildPrerequisiteGraph", n, [&]() {
+			return BestOf(std::min(runs, 5), [&]() {
+				LoadResult loaded { LoadCatalog(catalog.csv_path) };
+				g_sink = BuildPrerequisiteGraph(loaded.table).size();
+			});
+		});
+		measure("ApplyCatalogDelta", 32, [&]() {
+			// through the menu's path: a published catalog changed in place
+			HashTable<> changed;
+			for (const Course &course : catalog.courses) {
+				changed.insert(course);
+			}
+			PrerequisiteGraph graph { BuildPrerequisiteGraph(changed) };
+			HotCatalog<HashTable<>> published { std::move(changed) };
+			CatalogDelta add, remove;
+			add.opened = remove.opened = true;
+			for (std::size_t i = 0; i < std::min<std::size_t>(12, keys.size()); ++i) {
+				Course course { published.read([&](const HashTable<> &table) {
+					return *table.find(keys[i]);
+				}) };
+				course.title += " (revised)";
+				add.changes.push_back({ ChangeKind::Update, course, i + 1 });
+				remove.changes.push_back({ ChangeKind::Update, course, i + 1 });
+			}
+			for (std::size_t i = 0; i < 4; ++i) {
+				Course course { "BENCH" + std::to_string(i), "Added Course", { } };
+				if (i < keys.size()) {
+					course.prerequisites.push_back(keys[i]);
+				}
+				add.changes.push_back({ ChangeKind::Add, course, add.changes.size() + 1 });
+				remove.changes.push_back({ ChangeKind::Remove, { course.number, { }, { } }, remove.changes.size() + 1 });
+			}
+			return BestOf(runs, [&]() {
+				for (const CatalogDelta *delta : { &add, &remove }) {
+					published.apply([&](HashTable<> &table) {
+						DeltaReport report { ApplyCatalogDelta(table, graph, *delta) };
+						g_sink = report.recomputed;
+						return report.ok();
+					});
+				}
+			});
+		});
+		// index only, then decode on access
+		measure("LazyCatalog::open", n, [&]() {
+			return BestOf(std::min(runs, 5), [&]() {
+				g_sink = LazyCatalog { catalog.csv_path }.size();
+			});
+		});
+		LazyCatalog lazy { catalog.csv_path };
+		measure("LazyCatalog::title", n, [&]() {
+			return BestOf(runs, [&]() {
+				std::uint64_t found { };
+				for (const std::string &key : keys) {
+					found += lazy.title(key).size();
+				}
+				g_sink = found;
+			});
+		});
+		measure("LazyCatalog::find", n, [&]() {
+			return BestOf(runs, [&]() {
+				std::uint64_t found { };
+				for (const std::string &key : keys) {
+					found += lazy.find(key) != nullptr;
+				}
+				g_sink = found;
+			});
+		});
+		measure("ValidateFile", n, [&]() {
+			return BestOf(runs, [&]() {
+				g_sink = ValidateFile(catalog.csv_path);
+			});
+		});
+		measure("Quicksort", n, [&]() {
+			std::vector<Course> shuffled { catalog.courses }, sorting;
+			std::shuffle(shuffled.begin(), shuffled.end(), std::mt19937 { 7 });
+			return BestOfWithSetup(runs, [&]() {
+				sorting = shuffled;
+			}, [&]() {
+				Quicksort(&sorting, 0, static_cast<int>(sorting.size()) - 1);
+			});
+		});
+		measure("SortCourses", n, [&]() {
+			return BestOf(runs, [&]() {
+				g_sink = SortCourses(table).size();
+			});
+		});
+		// the same scans over the columnar store
+		CourseColumns columns;
+		for (const Course &course : catalog.courses) {
+			columns.insert(course);
+		}
+		measure("CourseColumns::numbersSorted", n, [&]() {
+			return BestOf(runs, [&]() {
+				g_sink = columns.numbersSorted().size();
+			});
+		});
+		measure("scan/no prerequisites", n, [&]() {
+			return BestOf(runs, [&]() {
+				std::vector<const Course *> found;
+				table.for_each([&](const Course &course) {
+					if (course.prerequisites.empty()) {
+						found.push_back(&course);
+					}
+				});
+				g_sink = found.size();
+			});
+		});
+		measure("CourseColumns::withoutPrerequisites", n, [&]() {
+			return BestOf(runs, [&]() {
+				g_sink = columns.withoutPrerequisites().size();
+			});
+		});
+		measure("scan/missing prerequisites", n, [&]() {
+			return BestOf(runs, [&]() {
+				std::uint64_t missing { };
+				table.for_each([&](const Course &course) {
+					for (const std::string &prerequisite : course.prerequisites) {
+						missing += !table.contains(prerequisite);
+					}
+				});
+				g_sink = missing;
+			});
+		});
+		measure("CourseColumns::countMissingPrerequisites", n, [&]() {
+			return BestOf(runs, [&]() {
+				g_sink = columns.countMissingPrerequisites();
+			});
+		});
+	}
+
+	// JSON string contents; names and paths here need no more than quotes and backslashes escaped
+	std::string escaped(std::string_view text) {
+		std::string result;
+		for (char c : text) {
+			if (c == '"' || c == '\\') {
+				result.push_back('\\');
+			}
+			result.push_back(c);
+		}
+		return result;
+	}
+}
+
+int main(int argc, char *argv[]) {
+	bool json { false };
+	std::size_t max_courses { 1000000 };
+	std::string filter;
+	std::string path { "./CS 300 ABCU_Advising_Program_Input.csv" };
+	for (int i = 1; i < argc; ++i) {
+		std::string_view arg { argv[i] };
+		if (arg == "--json") {
+			json = true;
+		} else if (arg.starts_with("--max=")) {
+			max_courses = std::stoul(std::string { arg.substr(6) });
+		} else if (arg.starts_with("--filter=")) {
+			filter = arg.substr(9);
+		} else {
+			path = arg;
+		}
+	}
+	std::vector<Result> results;
+	// the bundled catalog, as loaded by the program
+	HashTable<> bundled;
+	bundled.loadFromCSV(path);
+	if (bundled.size() > 0) {
+		std::vector<Course> courses { bundled.toVector() };
+		run(Catalog { "csv " + path, std::move(courses), path }, filter, json ? std::cerr : std::cout, results);
+	} else {
+		std::cerr << "No courses loaded from file: " << path << ", running synthetic catalogs only" << std::endl;
+	}
+	for (std::size_t count = 1000; count <= max_courses; count *= 10) {
+		Catalog catalog { synthetic(count) };
+		run(catalog, filter, json ? std::cerr : std::cout, results);
+		std::remove(catalog.csv_path.c_str());
+	}
+	if (json) {
+		std::cout << "{\n  \"benchmarks\": [";
+		for (std::size_t i = 0; i < results.size(); ++i) {
+			const Result &result { results[i] };
+			std::cout << (i == 0 ? "\n" : ",\n") << "    {\"name\": \"" << escaped(result.name) << "\", \"catalog\": \"" << escaped(result.catalog)
+				<< "\", \"courses\": " << result.courses << ", \"runs\": " << result.runs
+				<< ", \"ns_per_op\": " << std::fixed << std::setprecision(2) << result.ns_per_op;
+			if (result.allocations_per_op >= 0) {
+				std::cout << ", \"allocations_per_op\": " << result.allocations_per_op;
+			}
+			std::cout << "}";
+		}
+		std::cout << "\n  ]\n}" << std::endl;
+	}
+}
@@ -0,0 +1,104 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+#include "HotCatalog.hpp"
+#include "HashTable.hpp"
+#include "Bench.hpp"
+
+/*
+ * Lookup latency percentiles of a HotCatalog, idle and while it is
+ * being reloaded back to back on a background thread
+ *
+ * usage: csc300_reload_bench [courses] [reader threads]
+ */
+
+namespace {
+	constexpr std::chrono::milliseconds RUN_TIME { 1000 };
+
+	HashTable<> makeTable(const std::vector<std::string> &numbers, const std::size_t &version) {
+		HashTable<> table;
+		table.reserve(numbers.size());
+		for (const std::string &number : numbers) {
+			table.insert(Course { number, "Version " + std::to_string(version), { } });
+		}
+		return table;
+	}
+
+	// every reader's lookup latencies in nanoseconds, sorted
+	std::vector<std::uint32_t> measure(const HotCatalog<HashTable<>> &catalog, const std::vector<std::string> &numbers, const unsigned int &readers) {
+		std::atomic<bool> stop { false };
+		std::vector<std::vector<std::uint32_t>> samples(readers);
+		{
+			std::vector<std::jthread> threads;
+			for (unsigned int t = 0; t < readers; ++t) {
+				threads.emplace_back([&, t]() {
+					std::mt19937 random { t };
+					std::uint64_t found { };
+					while (!stop.load(std::memory_order_relaxed)) {
+						const std::string &number { numbers[random() % numbers.size()] };
+						auto start { std::chrono::steady_clock::now() };
+						found += catalog.read([&](const HashTable<> &table) {
+							return table.contains(number);
+						});
+						std::chrono::duration<double, std::nano> elapsed { std::chrono::steady_clock::now() - start };
+						samples[t].push_back(static_cast<std::uint32_t>(std::min(elapsed.count(), 4e9)));
+					}
+					g_sink = found;
+				});
+			}
+			std::this_thread::sleep_for(RUN_TIME);
+			stop = true;
+		}
+		std::vector<std::uint32_t> all;
+		for (const std::vector<std::uint32_t> &thread : samples) {
+			all.insert(all.end(), thread.begin(), thread.end());
+		}
+		std::sort(all.begin(), all.end());
+		return all;
+	}
+
+	void report(const char *name, const std::vector<std::uint32_t> &latencies, const std::size_t &reloads) {
+		auto at = [&](double fraction) {
+			return latencies.empty() ? 0 : latencies[std::min(latencies.size() - 1, static_cast<std::size_t>(fraction * latencies.size()))];
+		};
+		std::cout << std::left << std::setw(16) << name << std::setw(12) << latencies.size()
+			<< std::setw(10) << at(0.5) << std::setw(10) << at(0.99) << std::setw(10) << at(0.999)
+			<< std::setw(10) << latencies.back() << reloads << std::endl;
+	}
+}
+
+int main(int argc, char *argv[]) {
+	std::size_t courses { argc > 1 ? std::stoul(argv[1]) : 200000 };
+	unsigned int readers { argc > 2 ? static_cast<unsigned int>(std::stoul(argv[2])) : std::max(1u, std::thread::hardware_concurrency() - 1) };
+	std::vector<std::string> numbers;
+	for (std::size_t i = 0; i < courses; ++i) {
+		numbers.push_back("CSCI" + std::to_string(100000 + i));
+	}
+	HotCatalog<HashTable<>> catalog { makeTable(numbers, 0) };
+	std::cout << courses << " courses, " << readers << " readers, latencies in ns" << std::endl;
+	std::cout << std::left << std::setw(16) << "" << std::setw(12) << "lookups" << std::setw(10) << "p50" << std::setw(10) << "p99"
+		<< std::setw(10) << "p99.9" << std::setw(10) << "max" << "reloads" << std::endl;
+	report("idle", measure(catalog, numbers, readers), 0);
+	// rebuild and publish full tables for as long as the readers run
+	std::atomic<bool> reloading { true };
+	std::atomic<std::size_t> reloads { };
+	std::jthread reloader { [&]() {
+		while (reloading.load()) {
+			catalog.reload([&, version = reloads.load() + 1]() {
+				return LoadResult<HashTable<>> { makeTable(numbers, version), static_cast<int>(numbers.size()), { }, true };
+			});
+			catalog.wait();
+			++reloads;
+		}
+	} };
+	std::vector<std::uint32_t> latencies { measure(catalog, numbers, readers) };
+	reloading = false;
+	reloader.join();
+	report("reloading", latencies, reloads.load());
+}
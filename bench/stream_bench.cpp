@@ -0,0 +1,120 @@
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "CatalogGenerator.hpp"
+#include "CsvLoader.hpp"
+#include "CsvStream.hpp"
+#include "Bench.hpp"
+
+/*
+ * Peak memory and throughput of StreamCatalog against LoadCatalog
+ *
+ * usage: csc300_stream_bench [courses] [path to csv]
+ *
+ * Loads the csv, or a generated catalog of the given size, with
+ * LoadCatalog, then streams it once per buffer size into a filter that
+ * counts courses without prerequisites. Peak is the growth of the peak
+ * resident set over the run, where /proc allows resetting it. Every
+ * stream must see the rows and the courses LoadCatalog does.
+ */
+
+namespace {
+	// kB value of a /proc/self/status field, 0 where unavailable
+	std::size_t statusKiB(const std::string &field) {
+		std::ifstream status { "/proc/self/status" };
+		std::string line;
+		while (std::getline(status, line)) {
+			if (line.starts_with(field + ":")) {
+				return std::stoul(line.substr(field.size() + 1));
+			}
+		}
+		return 0;
+	}
+
+	// start a new peak at the current resident set, false if the kernel can't
+	bool resetPeak() {
+		std::ofstream clear_refs { "/proc/self/clear_refs" };
+		return static_cast<bool>(clear_refs << "5" << std::flush);
+	}
+
+	struct Run {
+		double seconds { };
+		double peak_MiB { };
+	};
+
+	// time fn and measure how far it raised the peak resident set
+	template <typename F>
+	Run measure(F &&fn) {
+		bool peak { resetPeak() };
+		std::size_t before { statusKiB("VmRSS") };
+		auto start { std::chrono::steady_clock::now() };
+		fn();
+		std::chrono::duration<double> elapsed { std::chrono::steady_clock::now() - start };
+		std::size_t after { statusKiB("VmHWM") };
+		return { elapsed.count(), peak && after > before ? (after - before) / 1024.0 : 0 };
+	}
+
+	void report(const std::string &name, const Run &run, const int &rows, const std::size_t &errors) {
+		std::cout << std::left << std::setw(24) << name << std::setw(12) << rows << std::setw(10) << errors << std::fixed << std::setprecision(1)
+			<< std::setw(12) << run.seconds * 1e9 / std::max(rows, 1) << run.peak_MiB << std::endl;
+	}
+}
+
+int main(int argc, char *argv[]) {
+	std::uint64_t courses { argc > 1 ? std::stoull(argv[1]) : 1000000 };
+	std::string path;
+	bool generated { argc <= 2 };
+	if (generated) {
+		path = (std::filesystem::temp_directory_path() / "csc300_stream_bench.csv").string();
+		std::ofstream csv { path, std::ios::binary };
+		GenerateCatalog(csv, GeneratorOptions { .courses = courses });
+	} else {
+		path = argv[2];
+	}
+	std::cout << std::left << std::setw(24) << "reader" << std::setw(12) << "rows" << std::setw(10) << "errors" << std::setw(12) << "ns/row" << "peak MiB" << std::endl;
+	// streams first, so the heap LoadCatalog leaves behind does not hide their peaks
+	struct Streamed {
+		StreamResult result;
+		std::size_t leaves { };
+	};
+	std::vector<Streamed> streams;
+	for (std::size_t buffer_size : { std::size_t { 64 }, std::size_t { 4 << 10 }, std::size_t { 64 << 10 }, std::size_t { 1 << 20 } }) {
+		Streamed &streamed { streams.emplace_back() };
+		Run run { measure([&]() {
+			streamed.result = StreamCatalog(path, [&](const CsvRow &row, std::size_t) {
+				streamed.leaves += row.prerequisites.empty();
+			}, [](const LoadError &) { }, StreamOptions { buffer_size });
+		}) };
+		report("StreamCatalog " + std::to_string(buffer_size) + " B", run, streamed.result.row_count, streamed.result.error_count);
+	}
+	// the reference: everything in memory at once
+	LoadResult<> loaded;
+	Run load_run { measure([&]() {
+		loaded = LoadCatalog(path);
+	}) };
+	report("LoadCatalog", load_run, loaded.row_count, loaded.errors.size());
+	std::size_t leaves { };
+	loaded.table.for_each([&](const Course &course) {
+		leaves += course.prerequisites.empty();
+	});
+	// later rows replace earlier ones in the table, compare leaves only without repeats
+	bool unique { loaded.table.size() == static_cast<std::size_t>(loaded.row_count) };
+	int status { };
+	for (const Streamed &streamed : streams) {
+		// a buffer shorter than a row skips it, so only compare streams that saw every row
+		if (loaded.ok() && streamed.result.ok() && (streamed.result.row_count != loaded.row_count || (unique && streamed.leaves != leaves))) {
+			std::cout << "StreamCatalog differs from LoadCatalog" << std::endl;
+			status = -1;
+		}
+	}
+	g_sink = leaves;
+	if (generated) {
+		std::remove(path.c_str());
+	}
+	return status;
+}
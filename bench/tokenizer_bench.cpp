@@ -0,0 +1,109 @@
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "CsvLoader.hpp"
+#include "DelimiterScan.hpp"
+#include "MappedFile.hpp"
+#include "Bench.hpp"
+
+/*
+ * Compare CSV tokenizing strategies over a large in-memory catalog
+ *
+ * usage: csc300_tokenizer_bench [path to csv] [megabytes]
+ *
+ * The csv is repeated until the buffer reaches the requested size.
+ */
+
+// the loop HashTable::loadFromCSV and ValidateFile use: getline, find and substr per field
+std::uint64_t getlineSubstr(const std::string &data) {
+	std::istringstream csv { data };
+	std::string row, field;
+	std::uint64_t fields { };
+	while (getline(csv, row, '\n')) {
+		std::size_t start { };
+		std::size_t end { };
+		while ((end = row.find(',', start)) != std::string::npos) {
+			field = row.substr(start, end - start);
+			fields += !field.empty();
+			start = end + 1;
+		}
+		// start < length - 1, without underflowing on an empty row
+		fields += start + 1 < row.length();
+	}
+	return fields;
+}
+
+// string_view::find per field, no allocation
+std::uint64_t viewFind(std::string_view data) {
+	CsvRow row;
+	std::uint64_t fields { };
+	for (std::size_t start { }; start < data.size(); ) {
+		std::size_t end { data.find('\n', start) };
+		if (end == std::string_view::npos) {
+			end = data.size();
+		}
+		SplitRow(data.substr(start, end - start), row);
+		fields += row.field_count;
+		start = end + 1;
+	}
+	return fields;
+}
+
+// vectorized delimiter scan feeding the loader's row builder
+std::uint64_t tokenizeRows(std::string_view data) {
+	std::uint64_t fields { };
+	TokenizeRows(data, [&](const CsvRow &row, std::size_t) {
+		fields += row.field_count;
+	});
+	return fields;
+}
+
+int main(int argc, char *argv[]) {
+	std::string path { argc > 1 ? argv[1] : "./CS 300 ABCU_Advising_Program_Input.csv" };
+	std::size_t megabytes { argc > 2 ? std::stoul(argv[2]) : 64 };
+	MappedFile csv { path };
+	if (!csv.is_open() || csv.view().empty()) {
+		std::cout << "Failed to open file: " << path << std::endl;
+		return -1;
+	}
+	std::string data;
+	data.reserve(megabytes << 20);
+	while (data.size() < (megabytes << 20)) {
+		data += csv.view();
+		if (data.back() != '\n') {
+			data += '\n';
+		}
+	}
+	std::cout << data.size() / double(1 << 20) << " MiB, scanner: " << ScanDelimitersName() << std::endl;
+	const int REPEAT { 5 };
+	std::vector<std::uint32_t> offsets;
+	auto report = [&](const char *name, double seconds) {
+		std::cout << std::left << std::setw(28) << name << std::fixed << std::setprecision(1)
+			<< data.size() / seconds / (1 << 20) << " MiB/s" << std::endl;
+	};
+	// raw delimiter scan in 1 MiB blocks, as TokenizeRows does
+	auto scan = [&](auto scanner) {
+		return [&, scanner]() {
+			std::uint64_t found { };
+			for (std::size_t start { }; start < data.size(); start += 1 << 20) {
+				offsets.clear();
+				scanner(std::string_view { data }.substr(start, 1 << 20), offsets);
+				found += offsets.size();
+			}
+			g_sink = found;
+		};
+	};
+	report("scan scalar", BestOf(REPEAT, scan(ScanDelimitersScalar)));
+	report("scan simd", BestOf(REPEAT, scan(ScanDelimiters)));
+	report("getline + find + substr", BestOf(REPEAT, [&]() { g_sink = getlineSubstr(data); }));
+	report("string_view find", BestOf(REPEAT, [&]() { g_sink = viewFind(data); }));
+	report("TokenizeRows (simd)", BestOf(REPEAT, [&]() { g_sink = tokenizeRows(data); }));
+	// all row splitters must agree on the number of non-empty fields
+	if (viewFind(data) != tokenizeRows(data)) {
+		std::cout << "field counts differ between string_view find and TokenizeRows" << std::endl;
+		return -1;
+	}
+}
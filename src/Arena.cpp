@@ -0,0 +1,33 @@
+#include "Arena.hpp"
+#include <algorithm>
+
+/**
+ * Allocate bytes from the current block, starting a new block if it is full.
+ * Requests larger than a block get a block of their own.
+ *
+ * @param bytes The number of bytes
+ * @param align The alignment, a power of two
+ * @return The memory, uninitialized
+ */
+void *Arena::allocate(const std::size_t &bytes, const std::size_t &align) {
+	std::size_t padding { (align - reinterpret_cast<std::uintptr_t>(m_cur) % align) % align };
+	if (m_cur == nullptr || padding + bytes > m_left) {
+		std::size_t size { std::max(BLOCK_SIZE, bytes + align) };
+		m_blocks.emplace_back(new std::byte[size]);
+		m_cur = m_blocks.back().get();
+		m_left = size;
+		m_reserved += size;
+		padding = (align - reinterpret_cast<std::uintptr_t>(m_cur) % align) % align;
+	}
+	void *result { m_cur + padding };
+	m_cur += padding + bytes;
+	m_left -= padding + bytes;
+	return result;
+}
+
+/**
+ * @return Bytes held in blocks
+ */
+std::size_t Arena::bytes_reserved() const {
+	return m_reserved;
+}
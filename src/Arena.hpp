@@ -0,0 +1,32 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+/*
+ * Monotonic block allocator
+ *
+ * Hands out memory from large blocks and only releases it all at once,
+ * so destroying an arena costs one free per block rather than one per
+ * object. Only use it for trivially destructible objects.
+ */
+class Arena {
+	private:
+		static constexpr std::size_t BLOCK_SIZE { 1 << 20 };
+		std::vector<std::unique_ptr<std::byte[]>> m_blocks;
+		std::byte *m_cur { nullptr };
+		std::size_t m_left { };
+		std::size_t m_reserved { };
+
+	public:
+		void *allocate(const std::size_t &bytes, const std::size_t &align);
+		std::size_t bytes_reserved() const;
+		/*
+		 * Allocate count uninitialized T's
+		 */
+		template <typename T>
+		T *allocateArray(const std::size_t &count) {
+			return static_cast<T *>(allocate(sizeof(T) * count, alignof(T)));
+		}
+};
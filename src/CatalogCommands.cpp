@@ -0,0 +1,207 @@
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include "CatalogCommands.hpp"
+#include "CourseQuery.hpp"
+#include "Stats.hpp"
+
+namespace {
+	std::string_view trim(std::string_view text) {
+		while (!text.empty() && std::isspace(static_cast<unsigned char>(text.front()))) {
+			text.remove_prefix(1);
+		}
+		while (!text.empty() && std::isspace(static_cast<unsigned char>(text.back()))) {
+			text.remove_suffix(1);
+		}
+		return text;
+	}
+
+	bool sameWord(std::string_view a, std::string_view b) {
+		return std::equal(a.begin(), a.end(), b.begin(), b.end(), [](char x, char y) {
+			return std::tolower(static_cast<unsigned char>(x)) == std::tolower(static_cast<unsigned char>(y));
+		});
+	}
+
+	void search(std::string_view course_number, const HashTable<> &table, CourseWriter &writer) {
+		if (const Course *result { table.find(course_number) }) {
+			writer.write(*result);
+		} else {
+			writer.error("Could not find course with number: " + std::string { course_number });
+		}
+	}
+
+	void query(std::string_view text, const HashTable<> &table, CourseWriter &writer) {
+		CourseQuery query;
+		if (!ParseCourseQuery(text, query)) {
+			writer.error("Could not understand query: " + std::string { text });
+			return;
+		}
+		std::size_t before { writer.count() };
+		for (const Course &course : QueryCatalog(table, query)) {
+			writer.write(course);
+		}
+		if (writer.count() == before) {
+			writer.error("No courses match: " + std::string { text });
+		}
+	}
+
+	// the table's shape and the process wide counters as name and value
+	// fields; values are numbers or lists of numbers, so JSON needs no quoting
+	void stats(const HashTable<> &table, CourseWriter &writer) {
+		struct Field {
+			std::string name;
+			std::vector<std::string> values;
+			bool list;
+		};
+		std::vector<Field> fields;
+		auto number = [](double value) {
+			char text[32];
+			std::snprintf(text, sizeof(text), "%.3f", value);
+			return std::string { text };
+		};
+		auto list = [](const auto &counts) {
+			std::vector<std::string> values;
+			for (const auto &count : counts) {
+				values.push_back(std::to_string(count));
+			}
+			return values;
+		};
+		HashTableStats shape { table.stats() };
+		StatsReport report { CollectStats() };
+		fields.push_back({ "courses", { std::to_string(shape.size) }, false });
+		fields.push_back({ "slots", { std::to_string(shape.slots) }, false });
+		fields.push_back({ "old_slots", { std::to_string(shape.old_slots) }, false });
+		fields.push_back({ "load_factor", { number(shape.load_factor) }, false });
+		fields.push_back({ "mean_probe", { number(shape.mean_probe) }, false });
+		fields.push_back({ "max_probe", { std::to_string(shape.max_probe) }, false });
+		fields.push_back({ "probe_lengths", list(shape.probe_lengths), true });
+		fields.push_back({ "stats_enabled", { report.enabled ? "true" : "false" }, false });
+		if (report.enabled) {
+			for (std::size_t i = 0; i < STAT_COUNTERS; ++i) {
+				fields.push_back({ StatName(static_cast<StatCounter>(i)), { std::to_string(report.counters[i]) }, false });
+			}
+			fields.push_back({ "search_mean_probe", { number(report.meanProbe()) }, false });
+			fields.push_back({ "search_probes", list(report.probes), true });
+			for (std::size_t i = 0; i < STAT_PHASES; ++i) {
+				std::string name { StatName(static_cast<StatPhase>(i)) };
+				fields.push_back({ name + "_runs", { std::to_string(report.phase_runs[i]) }, false });
+				fields.push_back({ name + "_ms", { number(report.phase_ns[i] / 1e6) }, false });
+			}
+		}
+		if (writer.format() == OutputFormat::JsonLines) {
+			std::string line;
+			for (const Field &field : fields) {
+				line.append(line.empty() ? "{\"" : ",\"").append(field.name).append("\":").append(field.list ? "[" : "");
+				for (std::size_t i = 0; i < field.values.size(); ++i) {
+					line.append(i == 0 ? "" : ",").append(field.values[i]);
+				}
+				line.append(field.list ? "]" : "");
+			}
+			writer.line(line + "}");
+			return;
+		}
+		for (const Field &field : fields) {
+			std::string line { field.name + (writer.format() == OutputFormat::Csv ? "," : ": ") };
+			for (std::size_t i = 0; i < field.values.size(); ++i) {
+				line.append(i == 0 ? "" : " ").append(field.values[i]);
+			}
+			writer.line(line);
+		}
+	}
+
+	void plan(std::string_view course_number, const HashTable<> &table, const PrerequisiteGraph &graph, CourseWriter &writer) {
+		std::uint32_t id { table.contains(course_number) ? graph.id(course_number) : PrerequisiteGraph::INVALID };
+		if (id == PrerequisiteGraph::INVALID) {
+			writer.error("Could not find course with number: " + std::string { course_number });
+			return;
+		}
+		if (graph.term(id) == PrerequisiteGraph::INVALID) {
+			writer.error(std::string { course_number } + " has a prerequisite cycle");
+			return;
+		}
+		std::vector<std::uint32_t> steps { graph.closure(id).begin(), graph.closure(id).end() };
+		std::stable_sort(steps.begin(), steps.end(), [&](std::uint32_t a, std::uint32_t b) {
+			return graph.term(a) < graph.term(b);
+		});
+		for (std::uint32_t prerequisite : steps) {
+			writer.term(graph.term(prerequisite) + 1, graph.number(prerequisite));
+		}
+		writer.term(graph.term(id) + 1, course_number);
+	}
+}
+
+/**
+ * Answer one command line
+ *
+ * @param command The line, without its newline
+ * @param table The catalog
+ * @param graph The catalog's prerequisite graph
+ * @param writer Where the answer goes; format changes its format
+ * @return Whether anything was written, or Quit
+ */
+CommandResult RunCatalogCommand(std::string_view command, const HashTable<> &table, const PrerequisiteGraph &graph, CourseWriter &writer) {
+	command = trim(command);
+	if (command.empty() || command.front() == '#') {
+		return CommandResult::Ignored;
+	}
+	std::size_t space { command.find_first_of(" \t") };
+	std::string_view verb { command.substr(0, space) };
+	std::string_view argument { space == std::string_view::npos ? std::string_view { } : trim(command.substr(space)) };
+	if (sameWord(verb, "quit")) {
+		return CommandResult::Quit;
+	}
+	if (sameWord(verb, "stats") && argument.empty()) {
+		stats(table, writer);
+	} else if (sameWord(verb, "list") && argument.empty()) {
+		table.for_each_ordered([&](const Course &course) {
+			writer.write(course);
+		});
+	} else if (sameWord(verb, "format") && !argument.empty()) {
+		OutputFormat format;
+		if (!ParseOutputFormat(argument, format)) {
+			writer.error("Unknown format: " + std::string { argument });
+		} else {
+			writer.format(format);
+		}
+	} else if ((sameWord(verb, "search") || sameWord(verb, "find")) && !argument.empty()) {
+		search(argument, table, writer);
+	} else if (sameWord(verb, "query") && !argument.empty()) {
+		query(argument, table, writer);
+	} else if (sameWord(verb, "plan") && !argument.empty()) {
+		plan(argument, table, graph, writer);
+	} else if (argument.empty()) {
+		search(verb, table, writer);
+	} else {
+		writer.error("Unknown command: " + std::string { command });
+	}
+	return CommandResult::Answered;
+}
+
+/**
+ * Answer every command read from in, until its end or quit. Each answer
+ * is followed by an empty line, so a script can match answers to
+ * commands. Answers are buffered by the writer, not flushed one by one.
+ *
+ * @param in The commands, one per line
+ * @param table The catalog
+ * @param graph The catalog's prerequisite graph
+ * @param writer Where the answers go
+ * @return The number of commands answered
+ */
+std::size_t RunCatalogBatch(std::istream &in, const HashTable<> &table, const PrerequisiteGraph &graph, CourseWriter &writer) {
+	std::size_t answered { };
+	std::string line;
+	while (std::getline(in, line)) {
+		CommandResult result { RunCatalogCommand(line, table, graph, writer) };
+		if (result == CommandResult::Quit) {
+			break;
+		}
+		if (result == CommandResult::Answered) {
+			writer.line("");
+			++answered;
+		}
+	}
+	return answered;
+}
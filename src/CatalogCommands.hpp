@@ -0,0 +1,31 @@
+#pragma once
+#include <cstddef>
+#include <istream>
+#include <string_view>
+#include "CourseWriter.hpp"
+#include "HashTable.hpp"
+#include "PrerequisiteGraph.hpp"
+
+/*
+ * Line oriented catalog commands, shared by the menu, batch mode and
+ * the server
+ *
+ *   search CSCI300     print one course, a bare course number works too
+ *   list               print every course in order
+ *   query MATH*        print the courses matching a CourseQuery
+ *   plan CSCI300       print the course's prerequisites by earliest term
+ *   stats              print the table's load and probe lengths, and the
+ *                      counters and phase times of Stats.hpp
+ *   format json        switch the following answers to text, json or csv
+ *   quit               stop reading commands
+ * Blank lines and lines starting with # are ignored. Command names are
+ * case insensitive.
+ */
+enum class CommandResult {
+	Answered, // something was written
+	Ignored, // blank or comment, nothing was written
+	Quit
+};
+
+CommandResult RunCatalogCommand(std::string_view command, const HashTable<> &table, const PrerequisiteGraph &graph, CourseWriter &writer);
+std::size_t RunCatalogBatch(std::istream &in, const HashTable<> &table, const PrerequisiteGraph &graph, CourseWriter &writer);
@@ -0,0 +1,172 @@
+#include "CatalogDelta.hpp"
+#include <algorithm>
+#include <unordered_map>
+#include <unordered_set>
+#include "MappedFile.hpp"
+#include "Stats.hpp"
+
+/**
+ * Parse a change file
+ *
+ * @param data The file contents
+ * @return The changes and the lines that could not be parsed
+ */
+CatalogDelta ParseCatalogDelta(std::string_view data) {
+	CatalogDelta delta;
+	delta.opened = true;
+	CsvRow row;
+	std::size_t line { };
+	for (std::size_t start { }; start < data.size(); ) {
+		std::size_t end { std::min(data.find('\n', start), data.size()) };
+		std::string_view text { data.substr(start, end - start) };
+		start = end + 1;
+		++line;
+		if (!text.empty() && text.back() == '\r') {
+			text.remove_suffix(1);
+		}
+		if (text.empty() || text.front() == '#') {
+			continue;
+		}
+		std::size_t comma { text.find(',') };
+		std::string_view action { text.substr(0, comma) };
+		SplitRow(comma == std::string_view::npos ? std::string_view { } : text.substr(comma + 1), row);
+		CatalogChange change { ChangeKind::Add, { }, line };
+		if (action == "add" || action == "update") {
+			if (row.field_count < 2) {
+				delta.errors.push_back({ line, MinFieldsMessage(row.field_count) });
+				continue;
+			}
+			change.kind = action == "add" ? ChangeKind::Add : ChangeKind::Update;
+			change.course = { std::string { row.number }, std::string { row.title }, { row.prerequisites.begin(), row.prerequisites.end() } };
+		} else if (action == "remove") {
+			if (row.field_count < 1) {
+				delta.errors.push_back({ line, "A removal needs the course number." });
+				continue;
+			}
+			change.kind = ChangeKind::Remove;
+			change.course.number = row.number;
+		} else {
+			delta.errors.push_back({ line, "Unknown change, expected add, update or remove: " + std::string { action } });
+			continue;
+		}
+		delta.changes.push_back(std::move(change));
+	}
+	return delta;
+}
+
+/**
+ * Read and parse a change file
+ *
+ * @param file_path Path to the change file
+ * @return The changes and the lines that could not be parsed
+ */
+CatalogDelta LoadCatalogDelta(const std::string &file_path) {
+	MappedFile file { file_path };
+	if (!file.is_open()) {
+		CatalogDelta delta;
+		delta.errors.push_back({ 0, "Failed to open file: " + file_path });
+		return delta;
+	}
+	return ParseCatalogDelta(file.view());
+}
+
+/**
+ * Check a delta against a catalog without changing it. Changes are
+ * taken in file order, so a file may add a course and then update it.
+ * Only the edges the delta touches are looked at.
+ *
+ * @param table The catalog
+ * @param graph The catalog's prerequisite graph
+ * @param delta The changes
+ * @return Every problem found, in file order, empty if the delta applies
+ */
+std::vector<LoadError> CheckCatalogDelta(const HashTable<> &table, const PrerequisiteGraph &graph, const CatalogDelta &delta) {
+	std::vector<LoadError> errors;
+	// the last change to each number, which decides whether it exists afterwards
+	std::unordered_map<std::string_view, const CatalogChange *> last;
+	auto present = [&](std::string_view number) {
+		auto found { last.find(number) };
+		return found != last.end() ? found->second->kind != ChangeKind::Remove : table.contains(number);
+	};
+	for (const CatalogChange &change : delta.changes) {
+		bool exists { present(change.course.number) };
+		if (change.kind == ChangeKind::Add && exists) {
+			errors.push_back({ change.line, "Course already exists: " + change.course.number });
+		} else if (change.kind != ChangeKind::Add && !exists) {
+			errors.push_back({ change.line, "No course to " + std::string { change.kind == ChangeKind::Update ? "update" : "remove" } + ": " + change.course.number });
+		} else {
+			last[change.course.number] = &change;
+		}
+	}
+	for (const auto &[number, change] : last) {
+		if (change->kind != ChangeKind::Remove) {
+			for (const std::string &prerequisite : change->course.prerequisites) {
+				if (!present(prerequisite)) {
+					errors.push_back({ change->line, MissingPrerequisiteMessage(prerequisite) });
+				}
+			}
+		} else {
+			// courses the delta leaves alone still name their old prerequisites
+			for (std::uint32_t dependent : graph.dependents(graph.id(number))) {
+				std::string_view dependent_number { graph.number(dependent) };
+				if (!last.contains(dependent_number) && table.contains(dependent_number)) {
+					errors.push_back({ change->line, "Course is still a prerequisite of " + std::string { dependent_number } + ": " + std::string { number } });
+				}
+			}
+		}
+	}
+	std::stable_sort(errors.begin(), errors.end(), [](const LoadError &a, const LoadError &b) {
+		return a.line < b.line;
+	});
+	return errors;
+}
+
+/**
+ * Check a delta, then apply it to a catalog and its graph. Nothing is
+ * changed if the check finds a problem.
+ *
+ * @param table The catalog
+ * @param graph The catalog's prerequisite graph, built from table
+ * @param delta The changes
+ * @return The counts of what was applied, or the problems found
+ */
+DeltaReport ApplyCatalogDelta(HashTable<> &table, PrerequisiteGraph &graph, const CatalogDelta &delta) {
+	CSC300_TIME(Delta);
+	DeltaReport report;
+	report.errors = CheckCatalogDelta(table, graph, delta);
+	if (!report.ok()) {
+		return report;
+	}
+	for (const CatalogChange &change : delta.changes) {
+		switch (change.kind) {
+		case ChangeKind::Add:
+			++report.added;
+			table.insert(change.course);
+			break;
+		case ChangeKind::Update:
+			++report.updated;
+			table.insert(change.course);
+			break;
+		case ChangeKind::Remove:
+			++report.removed;
+			table.remove(change.course.number);
+			break;
+		}
+	}
+	// the graph only needs each number's final prerequisites
+	std::unordered_set<std::string_view> seen;
+	for (auto change { delta.changes.rbegin() }; change != delta.changes.rend(); ++change) {
+		if (!seen.insert(change->course.number).second) {
+			continue;
+		}
+		std::uint32_t id { graph.addCourse(change->course.number) };
+		graph.clearPrerequisites(id);
+		if (change->kind != ChangeKind::Remove) {
+			for (const std::string &prerequisite : change->course.prerequisites) {
+				graph.addPrerequisite(id, prerequisite);
+			}
+		}
+	}
+	report.recomputed = graph.update();
+	return report;
+}
@@ -0,0 +1,78 @@
+#pragma once
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "Course.hpp"
+#include "CsvLoader.hpp"
+#include "HashTable.hpp"
+#include "PrerequisiteGraph.hpp"
+
+/*
+ * Incremental catalog updates
+ *
+ * A change file lists the courses added, edited and retired since the
+ * catalog was loaded, one per line, as an action followed by a catalog
+ * row:
+ *   add,CSCI500,Compilers,CSCI300
+ *   update,CSCI300,Algorithms,CSCI200
+ *   remove,CSCI110
+ * update replaces the whole course, title and prerequisites. Blank lines
+ * and lines starting with # are skipped.
+ *
+ * ApplyCatalogDelta checks the changes, then makes them with the table's
+ * insert and remove. Only the prerequisite edges the changes touch are
+ * revalidated: the prerequisites of each added or updated course and,
+ * through the graph's reverse rows, the courses still naming a removed
+ * one. The table keeps its ordered index current in place, at a 4 byte
+ * shift per added or removed course (see HashTable), and the graph
+ * recomputes only the courses depending on a change (see
+ * PrerequisiteGraph::update), so applying costs O(changes) plus what
+ * they reach rather than a reload of the catalog. A delta with any
+ * error changes nothing.
+ */
+enum class ChangeKind {
+	Add, // the course must not exist yet
+	Update, // the course must exist
+	Remove // the course must exist and no remaining course may require it
+};
+
+/*
+ * One line of a change file
+ */
+struct CatalogChange {
+	ChangeKind kind { ChangeKind::Add };
+	Course course; // only the number for removals
+	std::size_t line { }; // 1 based
+};
+
+/*
+ * The changes of one change file, in file order
+ */
+struct CatalogDelta {
+	std::vector<CatalogChange> changes;
+	std::vector<LoadError> errors; // lines that could not be parsed
+	bool opened { false };
+	bool ok() const {
+		return opened && errors.empty();
+	}
+};
+
+/*
+ * What applying a delta did, or why it was refused
+ */
+struct DeltaReport {
+	std::size_t added { };
+	std::size_t updated { };
+	std::size_t removed { };
+	std::size_t recomputed { }; // graph vertices whose closure and term were recomputed
+	std::vector<LoadError> errors; // in file order, nothing was applied if any
+	bool ok() const {
+		return errors.empty();
+	}
+};
+
+CatalogDelta ParseCatalogDelta(std::string_view data);
+CatalogDelta LoadCatalogDelta(const std::string &file_path);
+std::vector<LoadError> CheckCatalogDelta(const HashTable<> &table, const PrerequisiteGraph &graph, const CatalogDelta &delta);
+DeltaReport ApplyCatalogDelta(HashTable<> &table, PrerequisiteGraph &graph, const CatalogDelta &delta);
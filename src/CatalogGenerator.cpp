@@ -0,0 +1,236 @@
+#include "CatalogGenerator.hpp"
+#include <algorithm>
+#include <bit>
+#include <charconv>
+#include <cmath>
+#include <string>
+#include <vector>
+
+namespace {
+	constexpr std::size_t BUFFER_SIZE { 1 << 20 };
+	const char *NAMED_DEPARTMENTS[] { "CSCI", "MATH", "PHYS", "CHEM", "BIOL", "ENGL", "HIST", "ECON" };
+	constexpr unsigned int MAX_DEPARTMENTS { 8 + 26 * 26 * 26 };
+	const char *LEADS[] { "Introduction to", "Advanced", "Applied", "Topics in", "Foundations of", "Principles of", "Seminar in", "Methods of" };
+	const char *SUBJECTS[] { "Algorithms", "Data Structures", "Operating Systems", "Networks", "Databases", "Compilers",
+		"Linear Algebra", "Calculus", "Statistics", "Discrete Mathematics", "Mechanics", "Thermodynamics",
+		"Organic Chemistry", "Genetics", "Ecology", "Composition", "Literature", "World History", "Microeconomics", "Macroeconomics" };
+	const char *PARTS[] { "", " I", " II", " III" };
+
+	std::uint64_t splitmix(std::uint64_t &state) {
+		std::uint64_t z { state += 0x9e3779b97f4a7c15 };
+		z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9;
+		z = (z ^ (z >> 27)) * 0x94d049bb133111eb;
+		return z ^ (z >> 31);
+	}
+
+	// a bijection on [0, n): a Feistel network over the next even power of
+	// two bits, walking the cycle until the value lands back in range
+	class Permutation {
+		private:
+			std::uint64_t m_n;
+			unsigned int m_half;
+			std::uint64_t m_keys[4];
+
+		public:
+			Permutation(const std::uint64_t &t_n, std::uint64_t seed) : m_n { t_n } {
+				unsigned int bits { static_cast<unsigned int>(std::bit_width(std::max<std::uint64_t>(t_n, 2) - 1)) };
+				m_half = (bits + 1) / 2;
+				for (std::uint64_t &key : m_keys) {
+					key = splitmix(seed);
+				}
+			}
+
+			std::uint64_t operator()(std::uint64_t i) const {
+				std::uint64_t mask { (std::uint64_t { 1 } << m_half) - 1 };
+				do {
+					std::uint64_t left { i >> m_half }, right { i & mask };
+					for (std::uint64_t key : m_keys) {
+						std::uint64_t state { right ^ key };
+						std::uint64_t next { left ^ (splitmix(state) & mask) };
+						left = right;
+						right = next;
+					}
+					i = (left << m_half) | right;
+				} while (i >= m_n);
+				return i;
+			}
+	};
+
+	struct Department {
+		std::string name;
+		std::uint64_t first; // catalog position of the department's first course
+		std::uint64_t size;
+		std::uint64_t base; // number of its first course, all numbers have the same width
+		unsigned int blocks; // "Aa"/"BB" blocks per colliding number
+	};
+
+	std::vector<Department> layout(const GeneratorOptions &options) {
+		std::uint64_t count { std::min<std::uint64_t>({ options.departments, MAX_DEPARTMENTS, options.courses }) };
+		std::vector<double> weights;
+		double total { };
+		for (std::uint64_t d = 0; d < std::max<std::uint64_t>(count, 1); ++d) {
+			weights.push_back(1 / std::pow(static_cast<double>(d + 1), options.skew));
+			total += weights.back();
+		}
+		std::vector<Department> departments;
+		std::uint64_t assigned { };
+		for (std::uint64_t d = 0; d < count; ++d) {
+			// at least one course each, the first department takes any rounding left over
+			std::uint64_t size { std::max<std::uint64_t>(1, static_cast<std::uint64_t>(options.courses * weights[d] / total)) };
+			size = std::min(size, options.courses - assigned - (count - d - 1));
+			std::string name;
+			if (d < std::size(NAMED_DEPARTMENTS)) {
+				name = NAMED_DEPARTMENTS[d];
+			} else {
+				std::uint64_t code { d - std::size(NAMED_DEPARTMENTS) };
+				name = { 'X', static_cast<char>('A' + code / 676), static_cast<char>('A' + code / 26 % 26), static_cast<char>('A' + code % 26) };
+			}
+			std::uint64_t base { 100 };
+			while (base * 9 < size) {
+				base *= 10;
+			}
+			departments.push_back(Department { name, 0, size, base, static_cast<unsigned int>(std::bit_width(std::max<std::uint64_t>(size, 2) - 1)) });
+			assigned += size;
+		}
+		if (!departments.empty()) {
+			departments[0].size += options.courses - assigned;
+			while (departments[0].base * 9 < departments[0].size) {
+				departments[0].base *= 10;
+			}
+			departments[0].blocks = static_cast<unsigned int>(std::bit_width(std::max<std::uint64_t>(departments[0].size, 2) - 1));
+		}
+		// sorted output walks departments by name
+		std::sort(departments.begin(), departments.end(), [](const Department &a, const Department &b) {
+			return a.name < b.name;
+		});
+		std::uint64_t first { };
+		for (Department &department : departments) {
+			department.first = first;
+			first += department.size;
+		}
+		return departments;
+	}
+
+	void appendNumber(std::string &buffer, const Department &department, const std::uint64_t &seq, const KeyPattern &keys) {
+		buffer.append(department.name);
+		if (keys == KeyPattern::Colliding) {
+			// "Aa" < "BB", so blocks from the high bit down keep numbers in seq order
+			for (unsigned int bit = department.blocks; bit-- > 0; ) {
+				buffer.append((seq >> bit & 1) ? "BB" : "Aa");
+			}
+			return;
+		}
+		char digits[24];
+		char *end { std::to_chars(digits, digits + sizeof(digits), department.base + seq).ptr };
+		buffer.append(digits, end);
+	}
+
+	std::uint64_t level(const std::uint64_t &seq, const Department &department, const unsigned int &depth) {
+		return seq * depth / department.size;
+	}
+}
+
+/**
+ * Parse a row order name
+ *
+ * @param text "shuffled", "sorted" or "reversed"
+ * @param order Set to the order if text names one
+ * @return false if text is not an order name
+ */
+bool ParseRowOrder(std::string_view text, RowOrder &order) {
+	if (text == "shuffled") {
+		order = RowOrder::Shuffled;
+	} else if (text == "sorted") {
+		order = RowOrder::Sorted;
+	} else if (text == "reversed") {
+		order = RowOrder::Reversed;
+	} else {
+		return false;
+	}
+	return true;
+}
+
+/**
+ * Parse a key pattern name
+ *
+ * @param text "catalog" or "colliding"
+ * @param keys Set to the pattern if text names one
+ * @return false if text is not a pattern name
+ */
+bool ParseKeyPattern(std::string_view text, KeyPattern &keys) {
+	if (text == "catalog") {
+		keys = KeyPattern::Catalog;
+	} else if (text == "colliding") {
+		keys = KeyPattern::Colliding;
+	} else {
+		return false;
+	}
+	return true;
+}
+
+/**
+ * Write a synthetic catalog as a course CSV, in 1 MiB writes
+ *
+ * @param out Where the rows go; check it afterwards for write errors
+ * @param options Size and shape of the catalog
+ * @return The number of rows written
+ */
+std::uint64_t GenerateCatalog(std::ostream &out, const GeneratorOptions &options) {
+	std::vector<Department> departments { layout(options) };
+	std::uint64_t total { options.courses };
+	unsigned int depth { std::max(1u, options.depth) };
+	Permutation shuffle { total, options.seed };
+	// department picks for prerequisites from other departments, weighted by size
+	std::vector<std::uint64_t> ends;
+	for (const Department &department : departments) {
+		ends.push_back(department.first + department.size);
+	}
+	std::string buffer;
+	buffer.reserve(BUFFER_SIZE + 4096);
+	std::vector<std::uint64_t> chosen; // this row's prerequisites, as catalog positions
+	std::uint64_t written { };
+	for (; written < total && out; ++written) {
+		std::uint64_t position { options.order == RowOrder::Sorted ? written : options.order == RowOrder::Reversed ? total - 1 - written : shuffle(written) };
+		std::size_t d { static_cast<std::size_t>(std::upper_bound(ends.begin(), ends.end(), position) - ends.begin()) };
+		const Department &department { departments[d] };
+		std::uint64_t seq { position - department.first };
+		// every row's choices depend only on its position, not on the row order
+		std::uint64_t state { options.seed ^ (position * 0xd1b54a32d192ed03) };
+		std::uint64_t r { splitmix(state) };
+		appendNumber(buffer, department, seq, options.keys);
+		buffer.push_back(',');
+		buffer.append(LEADS[r % std::size(LEADS)]).push_back(' ');
+		buffer.append(SUBJECTS[(r >> 8) % std::size(SUBJECTS)]).append(PARTS[(r >> 16) % std::size(PARTS)]);
+		std::uint64_t course_level { level(seq, department, depth) };
+		unsigned int count { course_level == 0 ? 0 : static_cast<unsigned int>((r >> 24) % (options.fan_out + 1)) };
+		chosen.clear();
+		// a few tries per prerequisite, lower levels of small departments may be empty
+		for (unsigned int attempt = 0; attempt < count * 4 && chosen.size() < count; ++attempt) {
+			std::uint64_t pick { splitmix(state) };
+			// three in four from the course's own department
+			std::size_t e { pick % 4 != 0 ? d : static_cast<std::size_t>(std::upper_bound(ends.begin(), ends.end(), (pick >> 2) % total) - ends.begin()) };
+			const Department &source { departments[e] };
+			// the courses of source below course_level are its first `below`
+			std::uint64_t below { (course_level * source.size + depth - 1) / depth };
+			if (below == 0) {
+				continue;
+			}
+			std::uint64_t prerequisite { source.first + (pick >> 32) % below };
+			if (std::find(chosen.begin(), chosen.end(), prerequisite) == chosen.end()) {
+				chosen.push_back(prerequisite);
+			}
+		}
+		for (std::uint64_t prerequisite : chosen) {
+			std::size_t p { static_cast<std::size_t>(std::upper_bound(ends.begin(), ends.end(), prerequisite) - ends.begin()) };
+			buffer.push_back(',');
+			appendNumber(buffer, departments[p], prerequisite - departments[p].first, options.keys);
+		}
+		buffer.push_back('\n');
+		if (buffer.size() >= BUFFER_SIZE) {
+			out.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+			buffer.clear();
+		}
+	}
+	out.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+	return written;
+}
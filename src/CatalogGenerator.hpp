@@ -0,0 +1,48 @@
+#pragma once
+#include <cstdint>
+#include <ostream>
+#include <string_view>
+
+/*
+ * Synthetic course catalogs for load and scale testing
+ *
+ * Courses are spread over departments with Zipf distributed sizes, so a
+ * few departments are large and most are small. Within a department,
+ * course numbers run upward and are split into depth levels like 100
+ * and 200 level courses. A course may only require courses of lower
+ * levels, up to fan_out of them, mostly from its own department. That
+ * keeps the catalog acyclic and holds the longest prerequisite chain to
+ * depth courses. Every prerequisite is a course in the catalog, so the
+ * output passes ValidateCatalog.
+ *
+ * Nothing is kept per course. Each row is derived from its position and
+ * the seed, so rows stream out at the speed of the output and the same
+ * options always produce the same file, in any row order.
+ */
+enum class RowOrder {
+	Shuffled, // a pseudo random permutation
+	Sorted, // by course number, the worst case for naive quicksorts
+	Reversed
+};
+
+enum class KeyPattern {
+	Catalog, // CSCI100-like numbers
+	// numbers made of "Aa" and "BB" blocks, which differ but collide
+	// completely under Polynomial31Hash within a department
+	Colliding
+};
+
+struct GeneratorOptions {
+	std::uint64_t courses { 100000 };
+	unsigned int departments { 64 };
+	double skew { 1.0 }; // Zipf exponent of department sizes, 0 for equal sizes
+	unsigned int fan_out { 3 }; // most prerequisites of one course
+	unsigned int depth { 6 }; // prerequisite levels per department
+	RowOrder order { RowOrder::Shuffled };
+	KeyPattern keys { KeyPattern::Catalog };
+	std::uint64_t seed { 42 };
+};
+
+bool ParseRowOrder(std::string_view text, RowOrder &order);
+bool ParseKeyPattern(std::string_view text, KeyPattern &keys);
+std::uint64_t GenerateCatalog(std::ostream &out, const GeneratorOptions &options);
@@ -0,0 +1,251 @@
+#include "CatalogServer.hpp"
+#include <iostream>
+#include <string_view>
+#include <vector>
+#include "CatalogCommands.hpp"
+#if defined(__unix__) || defined(__APPLE__)
+#include <arpa/inet.h>
+#include <cerrno>
+#include <csignal>
+#include <cstring>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+#define CSC300_HAVE_SOCKETS
+#endif
+
+#ifdef CSC300_HAVE_SOCKETS
+namespace {
+	volatile std::sig_atomic_t g_stop { 0 };
+
+	extern "C" void stopServer(int) {
+		g_stop = 1;
+	}
+
+	struct Connection {
+		int fd { -1 };
+		std::string in { }; // received, not yet a whole line
+		std::string out { }; // answers not yet sent
+		std::size_t sent { }; // bytes of out already sent
+		OutputFormat format { OutputFormat::Text };
+		bool closing { false }; // nothing more is read, close once out is sent
+		bool quit { false }; // quit was received, later commands are not answered
+		explicit Connection(const int &t_fd) : fd { t_fd } { }
+	};
+
+	bool setNonBlocking(const int &fd) {
+		int flags { fcntl(fd, F_GETFL, 0) };
+		return flags >= 0 && fcntl(fd, F_SETFL, flags | O_NONBLOCK) == 0;
+	}
+
+	// bind and listen on a Unix socket path or a [host:]port, -1 on failure
+	int listenOn(const std::string &address) {
+		int fd { -1 };
+		if (address.find('/') != std::string::npos) {
+			sockaddr_un name { };
+			if (address.size() >= sizeof(name.sun_path)) {
+				std::cout << "Socket path too long: " << address << std::endl;
+				return -1;
+			}
+			name.sun_family = AF_UNIX;
+			std::memcpy(name.sun_path, address.c_str(), address.size() + 1);
+			// replace a socket left behind by an earlier server, never a regular file
+			struct stat info { };
+			if (lstat(address.c_str(), &info) == 0 && S_ISSOCK(info.st_mode)) {
+				unlink(address.c_str());
+			}
+			fd = socket(AF_UNIX, SOCK_STREAM, 0);
+			if (fd >= 0 && bind(fd, reinterpret_cast<sockaddr *>(&name), sizeof(name)) != 0) {
+				close(fd);
+				fd = -1;
+			}
+		} else {
+			std::size_t colon { address.rfind(':') };
+			std::string host { colon == std::string::npos ? "127.0.0.1" : address.substr(0, colon) };
+			std::string port { colon == std::string::npos ? address : address.substr(colon + 1) };
+			sockaddr_in name { };
+			name.sin_family = AF_INET;
+			char *end { };
+			unsigned long number { std::strtoul(port.c_str(), &end, 10) };
+			if (port.empty() || *end != '\0' || number > 65535 || inet_pton(AF_INET, host.c_str(), &name.sin_addr) != 1) {
+				std::cout << "Not a socket path or [host:]port: " << address << std::endl;
+				return -1;
+			}
+			name.sin_port = htons(static_cast<std::uint16_t>(number));
+			fd = socket(AF_INET, SOCK_STREAM, 0);
+			int reuse { 1 };
+			if (fd >= 0 && (setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse)) != 0
+				|| bind(fd, reinterpret_cast<sockaddr *>(&name), sizeof(name)) != 0)) {
+				close(fd);
+				fd = -1;
+			}
+		}
+		if (fd >= 0 && (listen(fd, SOMAXCONN) != 0 || !setNonBlocking(fd))) {
+			close(fd);
+			fd = -1;
+		}
+		if (fd < 0) {
+			std::cout << "Could not listen on " << address << ": " << std::strerror(errno) << std::endl;
+		}
+		return fd;
+	}
+
+	void answer(Connection &connection, std::string_view command, const HashTable<> &table, const PrerequisiteGraph &graph, CourseWriter &writer) {
+		CommandResult result { RunCatalogCommand(command, table, graph, writer) };
+		if (result == CommandResult::Quit) {
+			connection.quit = true;
+			connection.closing = true;
+		} else if (result == CommandResult::Answered) {
+			writer.line("");
+		}
+	}
+
+	// answer every whole line received so far, and the rest once the peer is done sending
+	void answer(Connection &connection, const HashTable<> &table, const PrerequisiteGraph &graph) {
+		if (connection.quit) {
+			return;
+		}
+		CourseWriter writer { connection.out, connection.format };
+		std::size_t start { };
+		for (std::size_t newline; !connection.quit && (newline = connection.in.find('\n', start)) != std::string::npos; start = newline + 1) {
+			answer(connection, std::string_view { connection.in }.substr(start, newline - start), table, graph, writer);
+		}
+		connection.in.erase(0, start);
+		if (connection.in.size() > catalog_server::MAX_LINE) {
+			writer.error("Command line too long");
+			connection.closing = true;
+		} else if (connection.closing && !connection.quit && !connection.in.empty()) {
+			answer(connection, connection.in, table, graph, writer);
+			connection.in.clear();
+		}
+		connection.format = writer.format();
+	}
+
+	// read what is available, false on a connection error
+	bool receive(Connection &connection) {
+		char buffer[1 << 14];
+		while (true) {
+			ssize_t count { read(connection.fd, buffer, sizeof(buffer)) };
+			if (count > 0) {
+				connection.in.append(buffer, static_cast<std::size_t>(count));
+				if (connection.in.size() > catalog_server::MAX_LINE) {
+					return true;
+				}
+			} else if (count == 0) {
+				connection.closing = true;
+				return true;
+			} else {
+				return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR;
+			}
+		}
+	}
+
+	// send what the peer will take, false on error
+	bool send(Connection &connection) {
+		while (connection.sent < connection.out.size()) {
+			ssize_t count { write(connection.fd, connection.out.data() + connection.sent, connection.out.size() - connection.sent) };
+			if (count < 0) {
+				return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR;
+			}
+			connection.sent += static_cast<std::size_t>(count);
+		}
+		// keep the buffer's capacity for the next answers
+		connection.out.clear();
+		connection.sent = 0;
+		return true;
+	}
+}
+#endif
+
+/**
+ * Serve the catalog until SIGINT or SIGTERM
+ *
+ * @param address A Unix socket path, or a TCP [host:]port
+ * @param table The catalog, must not change while serving
+ * @param graph The catalog's prerequisite graph
+ * @return 0 once stopped, -1 if the address could not be listened on
+ */
+int ServeCatalog(const std::string &address, const HashTable<> &table, const PrerequisiteGraph &graph) {
+#ifdef CSC300_HAVE_SOCKETS
+	int listener { listenOn(address) };
+	if (listener < 0) {
+		return -1;
+	}
+	g_stop = 0;
+	std::signal(SIGINT, stopServer);
+	std::signal(SIGTERM, stopServer);
+	std::signal(SIGPIPE, SIG_IGN);
+	// the ordered index is built lazily, build it before the first list
+	table.ordered();
+	std::cout << "Serving " << table.size() << " courses on " << address << std::endl;
+	std::vector<Connection> connections;
+	std::vector<pollfd> polled;
+	while (!g_stop) {
+		polled.assign(1, pollfd { listener, POLLIN, 0 });
+		for (const Connection &connection : connections) {
+			short events { connection.out.empty() ? short { 0 } : short { POLLOUT } };
+			if (!connection.closing && connection.out.size() < catalog_server::MAX_PENDING) {
+				events |= POLLIN;
+			}
+			polled.push_back(pollfd { connection.fd, events, 0 });
+		}
+		// wake up now and then, a signal between the check and poll is not lost for long
+		if (poll(polled.data(), polled.size(), 1000) < 0) {
+			if (errno == EINTR) {
+				continue;
+			}
+			std::cout << "poll failed: " << std::strerror(errno) << std::endl;
+			break;
+		}
+		// connections polled this round are connections[0, polled.size() - 1)
+		for (std::size_t i = 0; i + 1 < polled.size(); ++i) {
+			Connection &connection { connections[i] };
+			short events { polled[i + 1].revents };
+			bool open { true };
+			if (events & POLLIN) {
+				open = receive(connection);
+				answer(connection, table, graph);
+			} else if (events & (POLLERR | POLLHUP | POLLNVAL)) {
+				open = false;
+			}
+			if (open && !connection.out.empty()) {
+				open = send(connection);
+			}
+			if (!open || (connection.closing && connection.out.empty())) {
+				close(connection.fd);
+				connection.fd = -1;
+			}
+		}
+		std::erase_if(connections, [](const Connection &connection) {
+			return connection.fd < 0;
+		});
+		if (polled[0].revents & POLLIN) {
+			for (int client; (client = accept(listener, nullptr, nullptr)) >= 0; ) {
+				if (setNonBlocking(client)) {
+					connections.emplace_back(client);
+				} else {
+					close(client);
+				}
+			}
+		}
+	}
+	for (const Connection &connection : connections) {
+		close(connection.fd);
+	}
+	close(listener);
+	if (address.find('/') != std::string::npos) {
+		unlink(address.c_str());
+	}
+	std::signal(SIGINT, SIG_DFL);
+	std::signal(SIGTERM, SIG_DFL);
+	std::cout << "Stopped serving " << address << std::endl;
+	return 0;
+#else
+	std::cout << "Serving needs POSIX sockets, not available on this platform" << std::endl;
+	return -1;
+#endif
+}
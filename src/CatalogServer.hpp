@@ -0,0 +1,27 @@
+#pragma once
+#include <string>
+#include "HashTable.hpp"
+#include "PrerequisiteGraph.hpp"
+
+/*
+ * Long running catalog server
+ *
+ * Keeps one loaded catalog resident and answers CatalogCommands over
+ * sockets, so scripts pay process startup and the CSV load once rather
+ * than per query. One thread runs a poll() event loop over non blocking
+ * sockets: each connection reads commands a line at a time and gets the
+ * same answers as batch mode, each followed by an empty line. Commands
+ * sent back to back are answered back to back without waiting for the
+ * client to read, up to MAX_PENDING bytes of unread answers. The format
+ * command applies to its connection only.
+ *
+ * The address is a Unix socket path (anything containing a /) or a TCP
+ * port, optionally as host:port; a bare port listens on 127.0.0.1 only.
+ * SIGINT and SIGTERM stop the server.
+ */
+namespace catalog_server {
+	constexpr std::size_t MAX_LINE { 1 << 16 }; // longer command lines close the connection
+	constexpr std::size_t MAX_PENDING { 1 << 22 }; // stop reading a connection with this much unsent
+}
+
+int ServeCatalog(const std::string &address, const HashTable<> &table, const PrerequisiteGraph &graph);
@@ -0,0 +1,246 @@
+#pragma once
+#include <atomic>
+#include <bit>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string_view>
+#include <utility>
+#include "Course.hpp"
+#include "Epoch.hpp"
+#include "Hash.hpp"
+#include "HashTable.hpp"
+
+/*
+ * Course table for many reader threads and occasional writers
+ *
+ * Keys are spread over a power of two number of shards, each an
+ * immutable HashTable behind an atomic pointer. Readers pin an
+ * EpochDomain, load the shard pointer and search it as a plain
+ * HashTable: no locks and no shared writes, so lookups scale with reader
+ * threads. Writers lock only their key's shard, copy it, apply the
+ * HashTable insert or remove to the copy, publish the copy and retire
+ * the old version, which is deleted once the readers that might still
+ * see it are done. A write costs a copy of one shard, roughly
+ * size() / shard count courses, so the table suits read mostly loads.
+ *
+ * Each shard is a consistent snapshot; a reader never sees a half done
+ * insert, though reads across shards may straddle a write.
+ */
+template <typename Hash = WyHash, typename Value = Course>
+class ConcurrentHashTable {
+	private:
+		using Table = HashTable<Hash, Value>;
+		// one cache line per shard so writers to different shards don't contend
+		struct alignas(64) Shard {
+			std::atomic<const Table *> table { nullptr };
+			std::mutex writer;
+		};
+		std::unique_ptr<Shard[]> m_shards;
+		unsigned int m_shard_bits { };
+		std::atomic<std::size_t> m_size { };
+		[[no_unique_address]] Hash m_hasher;
+		mutable EpochDomain m_epoch;
+		Shard &shard(std::string_view course_number) const;
+		template <typename F>
+		void update(std::string_view course_number, F &&change);
+
+	public:
+		static constexpr unsigned int DEFAULT_SHARDS { 256 };
+		ConcurrentHashTable(const unsigned int &t_shards = DEFAULT_SHARDS);
+		ConcurrentHashTable(Table &&table, const unsigned int &t_shards = DEFAULT_SHARDS);
+		ConcurrentHashTable(const ConcurrentHashTable &) = delete;
+		ConcurrentHashTable &operator=(const ConcurrentHashTable &) = delete;
+		~ConcurrentHashTable();
+		void insert(const Value &course);
+		void insert(Value &&course);
+		void remove(std::string_view course_number);
+		Value search(std::string_view course_number) const;
+		bool contains(std::string_view course_number) const;
+		template <typename F>
+		bool visit(std::string_view course_number, F &&fn) const;
+		template <typename F>
+		void for_each(F &&fn) const;
+		std::size_t size() const;
+		unsigned int shard_count() const;
+};
+
+/**
+ * Create an empty table
+ *
+ * @param t_shards The number of shards, rounded up to a power of two
+ */
+template <typename Hash, typename Value>
+ConcurrentHashTable<Hash, Value>::ConcurrentHashTable(const unsigned int &t_shards) {
+	unsigned int shards { std::bit_ceil(std::max(1u, t_shards)) };
+	m_shard_bits = static_cast<unsigned int>(std::countr_zero(shards));
+	m_shards.reset(new Shard[shards]);
+	for (unsigned int i = 0; i < shards; ++i) {
+		m_shards[i].table.store(new Table { }, std::memory_order_relaxed);
+	}
+}
+
+/**
+ * Take over a loaded table, splitting it into shards
+ *
+ * @param table The table, left empty
+ * @param t_shards The number of shards, rounded up to a power of two
+ */
+template <typename Hash, typename Value>
+ConcurrentHashTable<Hash, Value>::ConcurrentHashTable(Table &&table, const unsigned int &t_shards) : ConcurrentHashTable(t_shards) {
+	// nothing is published yet, fill the shards in place
+	for (unsigned int i = 0; i < shard_count(); ++i) {
+		const_cast<Table *>(m_shards[i].table.load(std::memory_order_relaxed))->reserve(table.size() / shard_count() + 1);
+	}
+	for (const Value &course : table) {
+		const_cast<Table *>(shard(course.number).table.load(std::memory_order_relaxed))->insert(course);
+	}
+	m_size.store(table.size(), std::memory_order_relaxed);
+	table = Table { };
+}
+
+template <typename Hash, typename Value>
+ConcurrentHashTable<Hash, Value>::~ConcurrentHashTable() {
+	for (unsigned int i = 0; i < shard_count(); ++i) {
+		delete m_shards[i].table.load(std::memory_order_relaxed);
+	}
+}
+
+/**
+ * @param course_number A course number
+ * @return The shard its course lives in, picked by the top hash bits
+ *         so shard choice doesn't correlate with slots inside the shard
+ */
+template <typename Hash, typename Value>
+typename ConcurrentHashTable<Hash, Value>::Shard &ConcurrentHashTable<Hash, Value>::shard(std::string_view course_number) const {
+	std::uint64_t h { m_hasher(course_number) };
+	return m_shards[m_shard_bits == 0 ? 0 : h >> (64 - m_shard_bits)];
+}
+
+/**
+ * Copy on write: copy the key's shard, change the copy, publish it and
+ * retire the old version
+ *
+ * @param course_number The key being written
+ * @param change Called as change(Table &) on the copy
+ */
+template <typename Hash, typename Value>
+template <typename F>
+void ConcurrentHashTable<Hash, Value>::update(std::string_view course_number, F &&change) {
+	Shard &target { shard(course_number) };
+	const Table *old;
+	{
+		std::lock_guard<std::mutex> lock { target.writer };
+		old = target.table.load(std::memory_order_relaxed);
+		Table *copy { new Table { *old } };
+		change(*copy);
+		m_size.fetch_add(copy->size() - old->size(), std::memory_order_relaxed);
+		target.table.store(copy, std::memory_order_release);
+	}
+	m_epoch.retire(old);
+}
+
+/**
+ * Insert a course, replacing one with the same number
+ *
+ * @param course The course to insert
+ */
+template <typename Hash, typename Value>
+void ConcurrentHashTable<Hash, Value>::insert(const Value &course) {
+	update(course.number, [&](Table &table) {
+		table.insert(course);
+	});
+}
+
+template <typename Hash, typename Value>
+void ConcurrentHashTable<Hash, Value>::insert(Value &&course) {
+	std::string_view number { course.number };
+	update(number, [&](Table &table) {
+		table.insert(std::move(course));
+	});
+}
+
+/**
+ * Remove a course, if present
+ *
+ * @param course_number The course number to remove
+ */
+template <typename Hash, typename Value>
+void ConcurrentHashTable<Hash, Value>::remove(std::string_view course_number) {
+	update(course_number, [&](Table &table) {
+		table.remove(course_number);
+	});
+}
+
+/**
+ * Call fn(const Value &) on a course while it is guaranteed to stay alive
+ *
+ * @param course_number The course number to search for
+ * @param fn Called with the course if found; must not keep references to it
+ * @return true if the course was found
+ */
+template <typename Hash, typename Value>
+template <typename F>
+bool ConcurrentHashTable<Hash, Value>::visit(std::string_view course_number, F &&fn) const {
+	const Shard &target { shard(course_number) };
+	EpochDomain::Guard guard { m_epoch };
+	if (const Value *course { target.table.load(std::memory_order_acquire)->find(course_number) }) {
+		fn(*course);
+		return true;
+	}
+	return false;
+}
+
+/**
+ * Search for the specified course number
+ *
+ * @param course_number The course number to search for
+ * @return A copy of the course, or an empty course if not found
+ */
+template <typename Hash, typename Value>
+Value ConcurrentHashTable<Hash, Value>::search(std::string_view course_number) const {
+	Value result { };
+	visit(course_number, [&](const Value &course) {
+		result = course;
+	});
+	return result;
+}
+
+/**
+ * @param course_number The course number to search for
+ * @return true if the course is in the table
+ */
+template <typename Hash, typename Value>
+bool ConcurrentHashTable<Hash, Value>::contains(std::string_view course_number) const {
+	return visit(course_number, [](const Value &) { });
+}
+
+/**
+ * Call fn(const Value &) for every course, one shard snapshot at a time
+ *
+ * @param fn The function to call; must not keep references to courses
+ */
+template <typename Hash, typename Value>
+template <typename F>
+void ConcurrentHashTable<Hash, Value>::for_each(F &&fn) const {
+	for (unsigned int i = 0; i < shard_count(); ++i) {
+		EpochDomain::Guard guard { m_epoch };
+		m_shards[i].table.load(std::memory_order_acquire)->for_each(fn);
+	}
+}
+
+/**
+ * @return The number of courses
+ */
+template <typename Hash, typename Value>
+std::size_t ConcurrentHashTable<Hash, Value>::size() const {
+	return m_size.load(std::memory_order_relaxed);
+}
+
+/**
+ * @return The number of shards
+ */
+template <typename Hash, typename Value>
+unsigned int ConcurrentHashTable<Hash, Value>::shard_count() const {
+	return 1u << m_shard_bits;
+}
@@ -0,0 +1,25 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <iostream>
+
+struct Course {
+	std::string number;
+	std::string title;
+	std::vector<std::string> prerequisites;
+	// prints to os without flushing it, CourseWriter buffers whole listings
+	friend std::ostream &operator<<(std::ostream &os, const Course &course) {
+		os << "Number: " << course.number << '\n' << "Title: " << course.title << '\n';
+		os << "Prerequisites: ";
+		// iter over prerequisites and print them
+		for (std::size_t i = 0; i < course.prerequisites.size(); ++i) {
+			// if last prerequisite, don't print comma
+			if (i == course.prerequisites.size() - 1) {
+				os << course.prerequisites[i];
+			} else {
+				os << course.prerequisites[i] << ", ";
+			}
+		}
+		return os;
+	}
+};
@@ -0,0 +1,181 @@
+#include "CourseArena.hpp"
+
+/**
+ * Insert a course, copying its strings into the catalog
+ *
+ * @param course The course to insert
+ */
+void CourseArena::insert(const Course &course) {
+	std::span<std::uint32_t> prerequisites { allocatePrerequisites(course.prerequisites.size()) };
+	for (std::size_t i = 0; i < prerequisites.size(); ++i) {
+		prerequisites[i] = m_ids.intern(course.prerequisites[i]);
+	}
+	insert(course.number, course.title, prerequisites);
+}
+
+/**
+ * Insert a course whose prerequisites are already ids, replacing any
+ * course with the same number. number and title are interned here.
+ *
+ * @param number The course number
+ * @param title The course title
+ * @param prerequisites Prerequisite ids, typically from allocatePrerequisites
+ */
+void CourseArena::insert(std::string_view number, std::string_view title, std::span<const std::uint32_t> prerequisites) {
+	std::uint32_t id { m_ids.intern(number) };
+	if (id >= m_courses.size()) {
+		m_courses.resize(id + 1);
+	}
+	if (m_courses[id].id == CourseIds::INVALID) {
+		++m_size;
+	}
+	m_courses[id] = { id, m_ids.number(id), m_strings.intern(title), prerequisites };
+}
+
+/**
+ * Remove a course. Its id and strings stay allocated.
+ *
+ * @param course_number The course number to remove
+ */
+void CourseArena::remove(std::string_view course_number) {
+	std::uint32_t id { m_ids.find(course_number) };
+	if (defined(id)) {
+		m_courses[id] = ArenaCourse {};
+		--m_size;
+	}
+}
+
+/**
+ * Search for the specified course number
+ *
+ * @param course_number The course number to search for
+ * @return The course, or an empty course if not found
+ */
+ArenaCourse CourseArena::search(std::string_view course_number) const {
+	const ArenaCourse *course { find(course_number) };
+	return course != nullptr ? *course : ArenaCourse {};
+}
+
+/**
+ * @param course_number The course number to search for
+ * @return The course, or nullptr if not found
+ */
+const ArenaCourse *CourseArena::find(std::string_view course_number) const {
+	return find(m_ids.find(course_number));
+}
+
+/**
+ * @param id A course id
+ * @return The course with that id, or nullptr if it has no record
+ */
+const ArenaCourse *CourseArena::find(const std::uint32_t &id) const {
+	return defined(id) ? &m_courses[id] : nullptr;
+}
+
+/**
+ * Check whether a course number is in the catalog
+ *
+ * @param course_number The course number to search for
+ */
+bool CourseArena::contains(std::string_view course_number) const {
+	return defined(m_ids.find(course_number));
+}
+
+/**
+ * @param id A course id
+ * @return true if a course with that id is in the catalog
+ */
+bool CourseArena::defined(const std::uint32_t &id) const {
+	return id < m_courses.size() && m_courses[id].id != CourseIds::INVALID;
+}
+
+/**
+ * Get Vector representation of the catalog
+ *
+ * @return a vector of all course records, in id order
+ */
+std::vector<ArenaCourse> CourseArena::toVector() const {
+	std::vector<ArenaCourse> courses;
+	courses.reserve(m_size);
+	for_each([&](const ArenaCourse &course) {
+		courses.push_back(course);
+	});
+	return courses;
+}
+
+/**
+ * Copy a record into an owning Course
+ *
+ * @param course A record of this catalog
+ */
+Course CourseArena::toCourse(const ArenaCourse &course) const {
+	Course result { std::string { course.number }, std::string { course.title }, { } };
+	result.prerequisites.reserve(course.prerequisites.size());
+	for (std::uint32_t prerequisite : course.prerequisites) {
+		result.prerequisites.emplace_back(m_ids.number(prerequisite));
+	}
+	return result;
+}
+
+/**
+ * Print a record in the same format as Course's operator<<
+ *
+ * @param os The stream to print to
+ * @param course A record of this catalog
+ */
+void CourseArena::print(std::ostream &os, const ArenaCourse &course) const {
+	os << "Number: " << course.number << '\n' << "Title: " << course.title << '\n';
+	os << "Prerequisites: ";
+	for (std::size_t i = 0; i < course.prerequisites.size(); ++i) {
+		os << (i == 0 ? "" : ", ") << m_ids.number(course.prerequisites[i]);
+	}
+}
+
+/**
+ * @return The number of courses
+ */
+std::size_t CourseArena::size() const {
+	return m_size;
+}
+
+/**
+ * Make room for count courses without growing the id table
+ *
+ * @param count The number of courses
+ */
+void CourseArena::reserve(const std::size_t &count) {
+	m_ids.reserve(count);
+	m_courses.reserve(count);
+}
+
+/**
+ * Allocate room for prerequisite ids in the arena.
+ * A loader allocates one array for every row and hands out subspans.
+ *
+ * @param count The number of prerequisites
+ * @return Uninitialized ids
+ */
+std::span<std::uint32_t> CourseArena::allocatePrerequisites(const std::size_t &count) {
+	if (count == 0) {
+		return { };
+	}
+	return { m_strings.arena().allocateArray<std::uint32_t>(count), count };
+}
+
+/**
+ * @return The pool titles are interned in
+ */
+StringPool &CourseArena::strings() {
+	return m_strings;
+}
+
+/**
+ * @return The course number ids
+ */
+CourseIds &CourseArena::ids() {
+	return m_ids;
+}
+
+const CourseIds &CourseArena::ids() const {
+	return m_ids;
+}
@@ -0,0 +1,80 @@
+#pragma once
+#include <cstdint>
+#include <iostream>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "Arena.hpp"
+#include "Course.hpp"
+#include "CourseIds.hpp"
+
+/*
+ * Non-owning course record. The number comes from CourseIds, the title
+ * lives in a StringPool and prerequisites are course ids in an array
+ * shared by the whole catalog. Print through CourseArena::print, which
+ * resolves the ids back to numbers.
+ */
+struct ArenaCourse {
+	std::uint32_t id { CourseIds::INVALID }; // INVALID for an empty course
+	std::string_view number;
+	std::string_view title;
+	std::span<const std::uint32_t> prerequisites;
+};
+
+/*
+ * Arena backed course catalog
+ *
+ * Course numbers are interned to dense ids (CourseIds), which double as
+ * the lookup index: records sit in a vector indexed by id. Titles are
+ * interned in one StringPool and prerequisite lists are spans of ids
+ * carved out of arena memory. A catalog loaded by LoadCourseArena makes
+ * a handful of block sized allocations instead of several per course,
+ * tears down in O(1) per block, and validates prerequisites by checking
+ * an id against the record vector instead of hashing a string.
+ *
+ * Numbers that are only referenced as prerequisites also get ids, with
+ * no record. Removing a course does not return its memory.
+ */
+class CourseArena {
+	private:
+		StringPool m_strings;
+		CourseIds m_ids;
+		std::vector<ArenaCourse> m_courses; // indexed by id
+		std::size_t m_size { };
+
+	public:
+		void insert(const Course &course);
+		void insert(std::string_view number, std::string_view title, std::span<const std::uint32_t> prerequisites);
+		void remove(std::string_view course_number);
+		ArenaCourse search(std::string_view course_number) const;
+		const ArenaCourse *find(std::string_view course_number) const;
+		const ArenaCourse *find(const std::uint32_t &id) const;
+		bool contains(std::string_view course_number) const;
+		bool defined(const std::uint32_t &id) const;
+		std::vector<ArenaCourse> toVector() const;
+		template <typename F>
+		void for_each(F &&fn) const;
+		Course toCourse(const ArenaCourse &course) const;
+		void print(std::ostream &os, const ArenaCourse &course) const;
+		std::size_t size() const;
+		void reserve(const std::size_t &count);
+		std::span<std::uint32_t> allocatePrerequisites(const std::size_t &count);
+		StringPool &strings();
+		CourseIds &ids();
+		const CourseIds &ids() const;
+};
+
+/**
+ * Call fn(const ArenaCourse &) for every course, in id order
+ *
+ * @param fn The function to call
+ */
+template <typename F>
+void CourseArena::for_each(F &&fn) const {
+	for (const ArenaCourse &course : m_courses) {
+		if (course.id != CourseIds::INVALID) {
+			fn(course);
+		}
+	}
+}
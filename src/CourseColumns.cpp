@@ -0,0 +1,290 @@
+#include "CourseColumns.hpp"
+#include <algorithm>
+#include <bit>
+#include "Hash.hpp"
+#include "Sort.hpp"
+
+/**
+ * @param number The course number
+ * @return Its 32 bit hash
+ */
+std::uint32_t CourseColumns::hash(std::string_view number) {
+	std::uint64_t h { WyHash {}(number) };
+	return static_cast<std::uint32_t>(h ^ (h >> 32));
+}
+
+/**
+ * Re-place every row into an index of capacity slots
+ *
+ * @param capacity The new slot count, a power of two
+ */
+void CourseColumns::rehash(const std::size_t &capacity) {
+	std::vector<Slot> old_slots { std::move(m_slots) };
+	m_slots.assign(capacity, Slot {});
+	for (const Slot &slot : old_slots) {
+		if (slot.row != INVALID) {
+			std::size_t pos { slot.hash & (capacity - 1) };
+			while (m_slots[pos].row != INVALID) {
+				pos = (pos + 1) & (capacity - 1);
+			}
+			m_slots[pos] = slot;
+		}
+	}
+}
+
+/**
+ * Get the row of a course number, appending an undefined row on first sight
+ *
+ * @param number The course number
+ * @return Its row
+ */
+std::uint32_t CourseColumns::intern(std::string_view number) {
+	// keep the index at most half full
+	if ((rows() + 1) * 2 > m_slots.size()) {
+		rehash(m_slots.empty() ? 1024 : m_slots.size() * 2);
+	}
+	std::uint32_t h { hash(number) };
+	std::size_t mask { m_slots.size() - 1 };
+	std::size_t pos { h & mask };
+	while (m_slots[pos].row != INVALID) {
+		if (m_slots[pos].hash == h && this->number(m_slots[pos].row) == number) {
+			return m_slots[pos].row;
+		}
+		pos = (pos + 1) & mask;
+	}
+	std::uint32_t row { static_cast<std::uint32_t>(rows()) };
+	m_numbers.append(number);
+	m_number_offsets.push_back(static_cast<std::uint32_t>(m_numbers.size()));
+	m_title_begin.push_back(0);
+	m_title_size.push_back(0);
+	m_prerequisite_begin.push_back(0);
+	m_prerequisite_count.push_back(0);
+	m_defined.push_back(0);
+	m_slots[pos] = { h, row };
+	return row;
+}
+
+/**
+ * Insert a course, copying its strings into the columns
+ *
+ * @param course The course to insert
+ */
+void CourseColumns::insert(const Course &course) {
+	std::vector<std::uint32_t> prerequisites;
+	prerequisites.reserve(course.prerequisites.size());
+	for (const std::string &prerequisite : course.prerequisites) {
+		prerequisites.push_back(intern(prerequisite));
+	}
+	insert(course.number, course.title, prerequisites);
+}
+
+/**
+ * Insert a course whose prerequisites are already rows, replacing any
+ * course with the same number
+ *
+ * @param number The course number
+ * @param title The course title
+ * @param prerequisites Prerequisite rows, from intern
+ */
+void CourseColumns::insert(std::string_view number, std::string_view title, std::span<const std::uint32_t> prerequisites) {
+	std::uint32_t row { intern(number) };
+	if (!m_defined[row]) {
+		m_defined[row] = 1;
+		++m_size;
+	}
+	m_title_begin[row] = static_cast<std::uint32_t>(m_titles.size());
+	m_title_size[row] = static_cast<std::uint32_t>(title.size());
+	m_titles.append(title);
+	m_prerequisite_begin[row] = static_cast<std::uint32_t>(m_prerequisites.size());
+	m_prerequisite_count[row] = static_cast<std::uint32_t>(prerequisites.size());
+	m_prerequisites.insert(m_prerequisites.end(), prerequisites.begin(), prerequisites.end());
+}
+
+/**
+ * Remove a course. Its row and column data stay allocated.
+ *
+ * @param course_number The course number to remove
+ */
+void CourseColumns::remove(std::string_view course_number) {
+	std::uint32_t row { find(course_number) };
+	if (row != INVALID) {
+		m_defined[row] = 0;
+		--m_size;
+	}
+}
+
+/**
+ * @param course_number The course number to search for
+ * @return Its row, or INVALID if it is not a course
+ */
+std::uint32_t CourseColumns::find(std::string_view course_number) const {
+	if (m_slots.empty()) {
+		return INVALID;
+	}
+	std::uint32_t h { hash(course_number) };
+	std::size_t mask { m_slots.size() - 1 };
+	for (std::size_t pos { h & mask }; m_slots[pos].row != INVALID; pos = (pos + 1) & mask) {
+		if (m_slots[pos].hash == h && number(m_slots[pos].row) == course_number) {
+			return m_defined[m_slots[pos].row] ? m_slots[pos].row : INVALID;
+		}
+	}
+	return INVALID;
+}
+
+/**
+ * @param course_number The course number to search for
+ */
+bool CourseColumns::contains(std::string_view course_number) const {
+	return find(course_number) != INVALID;
+}
+
+/**
+ * @param row A row
+ * @return true if the row is a course
+ */
+bool CourseColumns::defined(const std::uint32_t &row) const {
+	return row < m_defined.size() && m_defined[row];
+}
+
+/**
+ * @param row A row, below rows()
+ * @return Its course number, valid until the next intern or insert
+ */
+std::string_view CourseColumns::number(const std::uint32_t &row) const {
+	return { m_numbers.data() + m_number_offsets[row], m_number_offsets[row + 1] - m_number_offsets[row] };
+}
+
+/**
+ * @param row A row, below rows()
+ * @return Its title, empty for a row that is not a course
+ */
+std::string_view CourseColumns::title(const std::uint32_t &row) const {
+	return { m_titles.data() + m_title_begin[row], m_title_size[row] };
+}
+
+/**
+ * @param row A row, below rows()
+ * @return The rows of its prerequisites
+ */
+std::span<const std::uint32_t> CourseColumns::prerequisites(const std::uint32_t &row) const {
+	return { m_prerequisites.data() + m_prerequisite_begin[row], m_prerequisite_count[row] };
+}
+
+/**
+ * Order the courses by number, reading only the number column
+ *
+ * @param threads Threads for sorting large catalogs, see ParallelSort
+ * @return The rows of every course, in course number order
+ */
+std::vector<std::uint32_t> CourseColumns::numbersSorted(const unsigned int &threads) const {
+	std::vector<SortEntry> entries;
+	entries.reserve(m_size);
+	for_each([&](const std::uint32_t &row) {
+		entries.push_back(MakeSortEntry(number(row), row));
+	});
+	ParallelSort(entries, threads);
+	std::vector<std::uint32_t> sorted;
+	sorted.reserve(entries.size());
+	for (const SortEntry &entry : entries) {
+		sorted.push_back(entry.index);
+	}
+	return sorted;
+}
+
+/**
+ * Find the courses with no prerequisites, reading only the defined and
+ * prerequisite count columns
+ *
+ * @return Their rows, in row order
+ */
+std::vector<std::uint32_t> CourseColumns::withoutPrerequisites() const {
+	// count first so the scan is a branch free reduction
+	std::size_t count { };
+	for (std::size_t row = 0; row < m_defined.size(); ++row) {
+		count += m_defined[row] & (m_prerequisite_count[row] == 0);
+	}
+	std::vector<std::uint32_t> found;
+	found.reserve(count);
+	for (std::uint32_t row = 0; row < m_defined.size(); ++row) {
+		if (m_defined[row] & (m_prerequisite_count[row] == 0)) {
+			found.push_back(row);
+		}
+	}
+	return found;
+}
+
+/**
+ * Count prerequisite references to numbers that are not courses,
+ * reading only the prerequisite and defined columns
+ *
+ * @return The number of missing prerequisite references
+ */
+std::size_t CourseColumns::countMissingPrerequisites() const {
+	std::size_t missing { };
+	for_each([&](const std::uint32_t &row) {
+		for (std::uint32_t prerequisite : prerequisites(row)) {
+			missing += !m_defined[prerequisite];
+		}
+	});
+	return missing;
+}
+
+/**
+ * Copy a row into an owning Course
+ *
+ * @param row A row that is a course
+ */
+Course CourseColumns::toCourse(const std::uint32_t &row) const {
+	Course result { std::string { number(row) }, std::string { title(row) }, { } };
+	result.prerequisites.reserve(m_prerequisite_count[row]);
+	for (std::uint32_t prerequisite : prerequisites(row)) {
+		result.prerequisites.emplace_back(number(prerequisite));
+	}
+	return result;
+}
+
+/**
+ * Print a course in the same format as Course's operator<<
+ *
+ * @param os The stream to print to
+ * @param row A row that is a course
+ */
+void CourseColumns::print(std::ostream &os, const std::uint32_t &row) const {
+	os << "Number: " << number(row) << '\n' << "Title: " << title(row) << '\n';
+	os << "Prerequisites: ";
+	std::span<const std::uint32_t> list { prerequisites(row) };
+	for (std::size_t i = 0; i < list.size(); ++i) {
+		os << (i == 0 ? "" : ", ") << number(list[i]);
+	}
+}
+
+/**
+ * @return The number of courses
+ */
+std::size_t CourseColumns::size() const {
+	return m_size;
+}
+
+/**
+ * @return The number of rows, courses and prerequisite only numbers
+ */
+std::size_t CourseColumns::rows() const {
+	return m_defined.size();
+}
+
+/**
+ * Make room for count rows without regrowing the columns or the index
+ *
+ * @param count The number of rows expected
+ */
+void CourseColumns::reserve(const std::size_t &count) {
+	m_number_offsets.reserve(count + 1);
+	m_title_begin.reserve(count);
+	m_title_size.reserve(count);
+	m_prerequisite_begin.reserve(count);
+	m_prerequisite_count.reserve(count);
+	m_defined.reserve(count);
+	if (count * 2 > m_slots.size()) {
+		rehash(std::bit_ceil(std::max<std::size_t>(count * 2, 1024)));
+	}
+}
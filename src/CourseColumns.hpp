@@ -0,0 +1,84 @@
+#pragma once
+#include <cstdint>
+#include <iostream>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "Course.hpp"
+
+/*
+ * Columnar (struct of arrays) course catalog
+ *
+ * Every distinct course number gets a row, counting up from 0 in order
+ * of first sight, whether it names a course or is only named as a
+ * prerequisite. Each field is its own dense column indexed by row:
+ *   numbers         one character column, with a row offset column
+ *   titles          one character column, with begin and size columns
+ *   prerequisites   one row id column, with begin and count columns
+ *   defined         1 for rows that are courses
+ * and a hash index maps numbers to rows. A scan touching one field,
+ * such as numbersSorted() or withoutPrerequisites(), streams through
+ * that field's column only instead of striding over whole courses.
+ *
+ * Replacing a course appends its new title and prerequisites and
+ * repoints its row; removing one clears its defined flag. Neither
+ * returns column memory.
+ */
+class CourseColumns {
+	private:
+		struct Slot {
+			std::uint32_t hash { };
+			std::uint32_t row { INVALID };
+		};
+		std::string m_numbers;
+		std::vector<std::uint32_t> m_number_offsets { 0 }; // rows + 1 entries
+		std::string m_titles;
+		std::vector<std::uint32_t> m_title_begin;
+		std::vector<std::uint32_t> m_title_size;
+		std::vector<std::uint32_t> m_prerequisites; // row ids
+		std::vector<std::uint32_t> m_prerequisite_begin;
+		std::vector<std::uint32_t> m_prerequisite_count;
+		std::vector<std::uint8_t> m_defined;
+		std::vector<Slot> m_slots; // open addressed, linear probing, at most half full
+		std::size_t m_size { };
+		void rehash(const std::size_t &capacity);
+		static std::uint32_t hash(std::string_view number);
+
+	public:
+		static constexpr std::uint32_t INVALID { UINT32_MAX };
+		std::uint32_t intern(std::string_view number);
+		void insert(const Course &course);
+		void insert(std::string_view number, std::string_view title, std::span<const std::uint32_t> prerequisites);
+		void remove(std::string_view course_number);
+		std::uint32_t find(std::string_view course_number) const;
+		bool contains(std::string_view course_number) const;
+		bool defined(const std::uint32_t &row) const;
+		std::string_view number(const std::uint32_t &row) const;
+		std::string_view title(const std::uint32_t &row) const;
+		std::span<const std::uint32_t> prerequisites(const std::uint32_t &row) const;
+		template <typename F>
+		void for_each(F &&fn) const;
+		std::vector<std::uint32_t> numbersSorted(const unsigned int &threads = 1) const;
+		std::vector<std::uint32_t> withoutPrerequisites() const;
+		std::size_t countMissingPrerequisites() const;
+		Course toCourse(const std::uint32_t &row) const;
+		void print(std::ostream &os, const std::uint32_t &row) const;
+		std::size_t size() const;
+		std::size_t rows() const;
+		void reserve(const std::size_t &count);
+};
+
+/**
+ * Call fn(row) for every row that is a course, in row order
+ *
+ * @param fn The function to call
+ */
+template <typename F>
+void CourseColumns::for_each(F &&fn) const {
+	for (std::uint32_t row = 0; row < m_defined.size(); ++row) {
+		if (m_defined[row]) {
+			fn(row);
+		}
+	}
+}
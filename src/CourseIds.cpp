@@ -0,0 +1,165 @@
+#include "CourseIds.hpp"
+#include <algorithm>
+#include "Hash.hpp"
+
+/**
+ * @param number The course number
+ * @return Its 32 bit hash
+ */
+std::uint32_t CourseIds::hash(std::string_view number) {
+	std::uint64_t h { WyHash {}(number) };
+	return static_cast<std::uint32_t>(h ^ (h >> 32));
+}
+
+/**
+ * Re-place every id into a table of capacity slots
+ *
+ * @param capacity The new slot count, a power of two
+ */
+void CourseIds::rehash(const std::size_t &capacity) {
+	std::vector<Slot> old_slots { std::move(m_slots) };
+	m_slots.assign(capacity, Slot {});
+	for (const Slot &slot : old_slots) {
+		if (slot.id != INVALID) {
+			std::size_t pos { slot.hash & (capacity - 1) };
+			while (m_slots[pos].id != INVALID) {
+				pos = (pos + 1) & (capacity - 1);
+			}
+			m_slots[pos] = slot;
+		}
+	}
+}
+
+/**
+ * Get the id of a course number, assigning the next id on first sight
+ *
+ * @param number The course number
+ * @return Its id
+ */
+std::uint32_t CourseIds::intern(std::string_view number) {
+	// keep the table at most half full
+	if ((m_numbers.size() + 1) * 2 > m_slots.size()) {
+		rehash(m_slots.empty() ? 1024 : m_slots.size() * 2);
+	}
+	std::uint32_t h { hash(number) };
+	std::size_t mask { m_slots.size() - 1 };
+	std::size_t pos { h & mask };
+	while (m_slots[pos].id != INVALID) {
+		if (m_slots[pos].hash == h && m_numbers[m_slots[pos].id] == number) {
+			return m_slots[pos].id;
+		}
+		pos = (pos + 1) & mask;
+	}
+	char *copy { m_arena.allocateArray<char>(number.size() + 1) };
+	std::copy(number.begin(), number.end(), copy);
+	copy[number.size()] = '\0';
+	std::uint32_t id { static_cast<std::uint32_t>(m_numbers.size()) };
+	m_numbers.emplace_back(copy, number.size());
+	m_slots[pos] = { h, id };
+	return id;
+}
+
+/**
+ * Get the id of a course number without assigning one
+ *
+ * @param number The course number
+ * @return Its id, or INVALID if it was never interned
+ */
+std::uint32_t CourseIds::find(std::string_view number) const {
+	if (m_slots.empty()) {
+		return INVALID;
+	}
+	std::uint32_t h { hash(number) };
+	std::size_t mask { m_slots.size() - 1 };
+	for (std::size_t pos { h & mask }; m_slots[pos].id != INVALID; pos = (pos + 1) & mask) {
+		if (m_slots[pos].hash == h && m_numbers[m_slots[pos].id] == number) {
+			return m_slots[pos].id;
+		}
+	}
+	return INVALID;
+}
+
+/**
+ * @param id A course id
+ * @return The course number the id was assigned to
+ */
+std::string_view CourseIds::number(const std::uint32_t &id) const {
+	return m_numbers[id];
+}
+
+/**
+ * @return The number of ids assigned
+ */
+std::size_t CourseIds::size() const {
+	return m_numbers.size();
+}
+
+/**
+ * Size the table for count course numbers
+ *
+ * @param count The number of course numbers
+ */
+void CourseIds::reserve(const std::size_t &count) {
+	std::size_t capacity { 1024 };
+	while (capacity < count * 2) {
+		capacity <<= 1;
+	}
+	if (capacity > m_slots.size()) {
+		rehash(capacity);
+	}
+	m_numbers.reserve(count);
+}
+
+/**
+ * @return The arena numbers are copied into
+ */
+Arena &CourseIds::arena() {
+	return m_arena;
+}
+
+/**
+ * @return The arena numbers are copied into
+ */
+const Arena &CourseIds::arena() const {
+	return m_arena;
+}
+
+/**
+ * Get the pooled copy of a string, copying it into the pool on first sight
+ *
+ * @param str The string to intern
+ * @return A view of the pooled copy
+ */
+std::string_view StringPool::intern(std::string_view str) {
+	return m_ids.number(m_ids.intern(str));
+}
+
+/**
+ * Size the pool for count distinct strings
+ *
+ * @param count The number of strings
+ */
+void StringPool::reserve(const std::size_t &count) {
+	m_ids.reserve(count);
+}
+
+/**
+ * @return The arena strings are copied into, shared with other catalog data
+ */
+Arena &StringPool::arena() {
+	return m_ids.arena();
+}
+
+/**
+ * @return The number of distinct strings
+ */
+std::size_t StringPool::size() const {
+	return m_ids.size();
+}
+
+/**
+ * @return Bytes held by the backing arena
+ */
+std::size_t StringPool::bytes_reserved() const {
+	return m_ids.arena().bytes_reserved();
+}
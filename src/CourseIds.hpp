@@ -0,0 +1,54 @@
+#pragma once
+#include <cstdint>
+#include <string_view>
+#include <vector>
+#include "Arena.hpp"
+
+/*
+ * Dense course number interning
+ *
+ * Gives every distinct course number a uint32_t id, counting up from 0,
+ * so catalogs can store prerequisites as id arrays and compare, index
+ * and validate them as integers. Ids are never reused. Numbers are
+ * copied into an Arena, the returned views stay valid across moves.
+ */
+class CourseIds {
+	private:
+		struct Slot {
+			std::uint32_t hash { };
+			std::uint32_t id { INVALID };
+		};
+		Arena m_arena;
+		std::vector<std::string_view> m_numbers; // indexed by id
+		std::vector<Slot> m_slots; // open addressed, linear probing
+		void rehash(const std::size_t &capacity);
+		static std::uint32_t hash(std::string_view number);
+
+	public:
+		static constexpr std::uint32_t INVALID { UINT32_MAX };
+		std::uint32_t intern(std::string_view number);
+		std::uint32_t find(std::string_view number) const;
+		std::string_view number(const std::uint32_t &id) const;
+		std::size_t size() const;
+		void reserve(const std::size_t &count);
+		Arena &arena();
+		const Arena &arena() const;
+};
+
+/*
+ * Interning string pool, the numbers of a CourseIds set without the ids
+ *
+ * Equal strings are stored once; the returned views stay valid for the
+ * life of the pool, including across moves.
+ */
+class StringPool {
+	private:
+		CourseIds m_ids;
+
+	public:
+		std::string_view intern(std::string_view str);
+		void reserve(const std::size_t &count);
+		Arena &arena();
+		std::size_t size() const;
+		std::size_t bytes_reserved() const;
+};
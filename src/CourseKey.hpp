@@ -0,0 +1,145 @@
+#pragma once
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+#include "Course.hpp"
+#include "Hash.hpp"
+
+/*
+ * Course number packed inline into 16 bytes
+ *
+ * Up to MAX_LENGTH ASCII letters and digits, zero padded, with the
+ * length in the last byte. Nothing is heap allocated, equality is two
+ * 64 bit compares and hash() mixes the same two words, so a table keyed
+ * by CourseKey never touches key bytes out of line. Zero padding keeps
+ * byte order equal to string order. Strings that do not fit (too long,
+ * empty, or with other characters) make an invalid key; check with
+ * CourseKey::parse first, or keep such catalogs on std::string keys.
+ * Invalid keys all compare equal and hash alike, so HashTable refuses
+ * them: inserting one does nothing and looking one up finds nothing.
+ * Converts implicitly to std::string_view, so it works wherever a
+ * course number is read as text.
+ */
+class CourseKey {
+	public:
+		static constexpr std::size_t MAX_LENGTH { 15 };
+
+	private:
+		static constexpr unsigned char INVALID { 0xff }; // length byte of an invalid key
+		std::array<char, 16> m_bytes { };
+
+	public:
+		constexpr CourseKey() { m_bytes[MAX_LENGTH] = static_cast<char>(INVALID); }
+		constexpr explicit CourseKey(std::string_view t_number) : CourseKey() { parse(t_number, *this); }
+		static constexpr bool valid(std::string_view number);
+		static constexpr bool parse(std::string_view number, CourseKey &key);
+		constexpr bool valid() const { return static_cast<unsigned char>(m_bytes[MAX_LENGTH]) != INVALID; }
+		constexpr std::size_t size() const { return valid() ? static_cast<unsigned char>(m_bytes[MAX_LENGTH]) : 0; }
+		constexpr std::string_view view() const { return { m_bytes.data(), size() }; }
+		constexpr operator std::string_view() const { return view(); }
+		constexpr std::uint64_t hash() const;
+		constexpr bool operator==(const CourseKey &other) const;
+		constexpr auto operator<=>(const CourseKey &other) const { return view() <=> other.view(); }
+		friend std::ostream &operator<<(std::ostream &os, const CourseKey &key) { return os << key.view(); }
+};
+
+static_assert(sizeof(CourseKey) == 16);
+
+/**
+ * @param number A course number
+ * @return Whether it fits a CourseKey: 1 to MAX_LENGTH letters and digits
+ */
+constexpr bool CourseKey::valid(std::string_view number) {
+	if (number.empty() || number.size() > MAX_LENGTH) {
+		return false;
+	}
+	// or of the bytes that are not letters or digits, no early exit to branch on
+	unsigned int other { };
+	for (char c : number) {
+		unsigned char u { static_cast<unsigned char>(c) };
+		other |= static_cast<unsigned int>(!((static_cast<unsigned int>(u - '0') < 10u) | (static_cast<unsigned int>((u | 0x20) - 'a') < 26u)));
+	}
+	return other == 0;
+}
+
+/**
+ * Pack a course number
+ *
+ * @param number The course number
+ * @param key Set to the packed number, or left alone if it does not fit
+ * @return Whether number fits a CourseKey
+ */
+constexpr bool CourseKey::parse(std::string_view number, CourseKey &key) {
+	if (!valid(number)) {
+		return false;
+	}
+	key.m_bytes = { };
+	if (std::is_constant_evaluated()) {
+		for (std::size_t i = 0; i < number.size(); ++i) {
+			key.m_bytes[i] = number[i];
+		}
+	} else {
+		std::memcpy(key.m_bytes.data(), number.data(), number.size());
+	}
+	key.m_bytes[MAX_LENGTH] = static_cast<char>(number.size());
+	return true;
+}
+
+/**
+ * @return A 64 bit hash of the two words, in the style of WyHash
+ */
+constexpr std::uint64_t CourseKey::hash() const {
+	constexpr std::uint64_t P0 { 0xa0761d6478bd642full }, P1 { 0xe7037ed1a0b428dbull };
+	auto words { std::bit_cast<std::array<std::uint64_t, 2>>(m_bytes) };
+	return hash_detail::mum(words[0] ^ P1, words[1] ^ P0);
+}
+
+constexpr bool CourseKey::operator==(const CourseKey &other) const {
+	auto a { std::bit_cast<std::array<std::uint64_t, 2>>(m_bytes) };
+	auto b { std::bit_cast<std::array<std::uint64_t, 2>>(other.m_bytes) };
+	return ((a[0] ^ b[0]) | (a[1] ^ b[1])) == 0;
+}
+
+/*
+ * Course whose number and prerequisites are CourseKeys, for
+ * HashTable<Hash, KeyedCourse>. Convert with ToKeyedCourse.
+ */
+struct KeyedCourse {
+	CourseKey number;
+	std::string title;
+	std::vector<CourseKey> prerequisites;
+	friend std::ostream &operator<<(std::ostream &os, const KeyedCourse &course) {
+		os << "Number: " << course.number << '\n' << "Title: " << course.title << '\n';
+		os << "Prerequisites: ";
+		for (std::size_t i = 0; i < course.prerequisites.size(); ++i) {
+			os << (i == 0 ? "" : ", ") << course.prerequisites[i];
+		}
+		return os;
+	}
+};
+
+/**
+ * @param course A course
+ * @param keyed Set to the course with packed numbers
+ * @return Whether its number and every prerequisite fit a CourseKey
+ */
+inline bool ToKeyedCourse(const Course &course, KeyedCourse &keyed) {
+	KeyedCourse result { CourseKey { course.number }, course.title, { } };
+	if (!result.number.valid()) {
+		return false;
+	}
+	result.prerequisites.reserve(course.prerequisites.size());
+	for (const std::string &prerequisite : course.prerequisites) {
+		if (!result.prerequisites.emplace_back(prerequisite).valid()) {
+			return false;
+		}
+	}
+	keyed = std::move(result);
+	return true;
+}
@@ -0,0 +1,66 @@
+#include "CourseQuery.hpp"
+#include <cctype>
+#include "Sort.hpp"
+
+namespace {
+	struct Bound {
+		std::string key;
+		bool prefix; // key matches every course number starting with it
+	};
+
+	/*
+	 * Normalize one side of a query: drop spaces and turn a trailing * or
+	 * level wildcard (3xx) into a prefix
+	 */
+	bool parseBound(std::string_view text, Bound &bound) {
+		bound = { };
+		for (char c : text) {
+			if (!std::isspace(static_cast<unsigned char>(c))) {
+				bound.key.push_back(c);
+			}
+		}
+		if (!bound.key.empty() && bound.key.back() == '*') {
+			bound.key.pop_back();
+			bound.prefix = true;
+		} else {
+			std::size_t wildcards { };
+			while (wildcards < bound.key.size() && (bound.key[bound.key.size() - 1 - wildcards] | 0x20) == 'x') {
+				++wildcards;
+			}
+			// only a wildcard when it follows a digit, "CSCI3xx" and not "LEX"
+			if (wildcards > 0 && wildcards < bound.key.size() && std::isdigit(static_cast<unsigned char>(bound.key[bound.key.size() - 1 - wildcards]))) {
+				bound.key.resize(bound.key.size() - wildcards);
+				bound.prefix = true;
+			}
+		}
+		return bound.prefix || !bound.key.empty();
+	}
+
+	// first course number after everything the bound matches, empty for none
+	std::string after(const Bound &bound) {
+		return bound.prefix ? PrefixSuccessor(bound.key) : bound.key + '\0';
+	}
+}
+
+/**
+ * Parse a prefix, level or range query, see CourseQuery.hpp for the forms
+ *
+ * @param text The query text
+ * @param query Set to the parsed query on success
+ * @return False if the query is malformed
+ */
+bool ParseCourseQuery(std::string_view text, CourseQuery &query) {
+	Bound low, high;
+	std::size_t dash { text.find('-') };
+	if (dash == std::string_view::npos) {
+		if (!parseBound(text, low)) {
+			return false;
+		}
+		high = low;
+	} else if (!parseBound(text.substr(0, dash), low) || !parseBound(text.substr(dash + 1), high)) {
+		return false;
+	}
+	// an inverted range is valid and simply matches nothing
+	query = { low.key, after(high) };
+	return true;
+}
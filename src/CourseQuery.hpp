@@ -0,0 +1,35 @@
+#pragma once
+#include <string>
+#include <string_view>
+
+/*
+ * Prefix and range queries over course numbers
+ *
+ * A query is a half open interval [first, last) of course numbers,
+ * answered lazily by a table's ordered index (see HashTable::range).
+ * ParseCourseQuery accepts:
+ *   MATH*              every course starting with MATH
+ *   CSCI 3xx           every CSCI course numbered 300 to 399
+ *   CSCI100            exactly CSCI100
+ *   CSCI100-CSCI299    CSCI100 through CSCI299, each side may use the forms above
+ * Spaces are ignored. Course numbers are compared byte for byte, as by
+ * search, so case matters: csci* finds csci300 but not CSCI300.
+ */
+struct CourseQuery {
+	std::string first; // lowest course number included
+	std::string last; // course number to stop before, empty for no upper bound
+};
+
+bool ParseCourseQuery(std::string_view text, CourseQuery &query);
+
+/*
+ * Run a query against a table
+ *
+ * @param table Any table with range(first, last) and rangeFrom(first)
+ * @param query The parsed query
+ * @return The table's lazy range of matching courses, in order
+ */
+template <typename Table>
+auto QueryCatalog(const Table &table, const CourseQuery &query) {
+	return query.last.empty() ? table.rangeFrom(query.first) : table.range(query.first, query.last);
+}
@@ -0,0 +1,254 @@
+#include <charconv>
+#include "CourseWriter.hpp"
+
+/**
+ * Parse an output format name
+ *
+ * @param text "text", "json" (or "jsonl") or "csv"
+ * @param format Set to the format if text names one
+ * @return false if text is not a format name
+ */
+bool ParseOutputFormat(std::string_view text, OutputFormat &format) {
+	if (text == "text") {
+		format = OutputFormat::Text;
+	} else if (text == "json" || text == "jsonl") {
+		format = OutputFormat::JsonLines;
+	} else if (text == "csv") {
+		format = OutputFormat::Csv;
+	} else {
+		return false;
+	}
+	return true;
+}
+
+/**
+ * @param t_os The stream to write to, must outlive the writer
+ * @param t_format How courses are formatted
+ */
+CourseWriter::CourseWriter(std::ostream &t_os, const OutputFormat &t_format) : m_os { &t_os }, m_format { t_format }, m_buffer { m_own } {
+	m_buffer.reserve(BUFFER_SIZE + BUFFER_SIZE / 4);
+}
+
+/**
+ * @param t_target The string to append to, must outlive the writer;
+ *        flush() leaves it alone
+ * @param t_format How courses are formatted
+ */
+CourseWriter::CourseWriter(std::string &t_target, const OutputFormat &t_format) : m_os { nullptr }, m_format { t_format }, m_buffer { t_target } { }
+
+CourseWriter::~CourseWriter() {
+	flush();
+}
+
+/**
+ * Write one course
+ *
+ * @param course The course to write
+ */
+void CourseWriter::write(const Course &course) {
+	write(course.number, course.title, course.prerequisites);
+}
+
+/**
+ * Write one step of a prerequisite plan
+ *
+ * @param term The term the course can be taken in, counted from 1
+ * @param number The course number
+ */
+void CourseWriter::term(const std::uint32_t &term, std::string_view number) {
+	char digits[16];
+	std::string_view text { digits, static_cast<std::size_t>(std::to_chars(digits, digits + sizeof(digits), term).ptr - digits) };
+	switch (m_format) {
+	case OutputFormat::Text:
+		m_buffer.append("Term ").append(text).append(": ").append(number).push_back('\n');
+		break;
+	case OutputFormat::JsonLines:
+		m_buffer.append("{\"term\":").append(text).append(",\"number\":");
+		appendQuoted(number);
+		m_buffer.append("}\n");
+		break;
+	case OutputFormat::Csv:
+		m_buffer.append(text).push_back(',');
+		appendQuoted(number);
+		m_buffer.push_back('\n');
+		break;
+	}
+	if (m_buffer.size() >= BUFFER_SIZE) {
+		drain();
+	}
+}
+
+/**
+ * Write a message saying a request could not be answered, as an
+ * {"error": message} object in JSON lines and as a plain line otherwise
+ *
+ * @param message The message
+ */
+void CourseWriter::error(std::string_view message) {
+	if (m_format == OutputFormat::JsonLines) {
+		m_buffer.append("{\"error\":");
+		appendQuoted(message);
+		m_buffer.append("}\n");
+		if (m_buffer.size() >= BUFFER_SIZE) {
+			drain();
+		}
+	} else {
+		line(message);
+	}
+}
+
+/**
+ * Write a line of plain text, such as a message between listings, in
+ * order with the buffered courses
+ *
+ * @param text The line, without its newline
+ */
+void CourseWriter::line(std::string_view text) {
+	m_buffer.append(text);
+	m_buffer.push_back('\n');
+	if (m_buffer.size() >= BUFFER_SIZE) {
+		drain();
+	}
+}
+
+/**
+ * Hand everything buffered to the stream and flush it
+ */
+void CourseWriter::flush() {
+	drain();
+	if (m_os != nullptr) {
+		m_os->flush();
+	}
+}
+
+/**
+ * @return The number of courses written so far
+ */
+std::size_t CourseWriter::count() const {
+	return m_count;
+}
+
+/**
+ * @return How courses are formatted
+ */
+OutputFormat CourseWriter::format() const {
+	return m_format;
+}
+
+/**
+ * Change how the following records are formatted
+ *
+ * @param t_format The new format
+ */
+void CourseWriter::format(const OutputFormat &t_format) {
+	m_format = t_format;
+}
+
+void CourseWriter::begin(std::string_view number, std::string_view title) {
+	switch (m_format) {
+	case OutputFormat::Text:
+		m_buffer.append("Number: ").append(number).append("\nTitle: ").append(title).append("\nPrerequisites: ");
+		break;
+	case OutputFormat::JsonLines:
+		m_buffer.append("{\"number\":");
+		appendQuoted(number);
+		m_buffer.append(",\"title\":");
+		appendQuoted(title);
+		m_buffer.append(",\"prerequisites\":[");
+		break;
+	case OutputFormat::Csv:
+		appendQuoted(number);
+		m_buffer.push_back(',');
+		appendQuoted(title);
+		break;
+	}
+}
+
+void CourseWriter::prerequisite(std::string_view number, const std::size_t &i) {
+	switch (m_format) {
+	case OutputFormat::Text:
+		if (i > 0) {
+			m_buffer.append(", ");
+		}
+		m_buffer.append(number);
+		break;
+	case OutputFormat::JsonLines:
+		if (i > 0) {
+			m_buffer.push_back(',');
+		}
+		appendQuoted(number);
+		break;
+	case OutputFormat::Csv:
+		m_buffer.push_back(',');
+		appendQuoted(number);
+		break;
+	}
+}
+
+void CourseWriter::end() {
+	switch (m_format) {
+	case OutputFormat::Text:
+		m_buffer.push_back('\n');
+		break;
+	case OutputFormat::JsonLines:
+		m_buffer.append("]}\n");
+		break;
+	case OutputFormat::Csv:
+		m_buffer.push_back('\n');
+		break;
+	}
+	++m_count;
+	if (m_buffer.size() >= BUFFER_SIZE) {
+		drain();
+	}
+}
+
+/**
+ * Append text as a JSON string, or as a CSV field quoted only if it has
+ * to be. Text output is never quoted.
+ *
+ * @param text The text to append
+ */
+void CourseWriter::appendQuoted(std::string_view text) {
+	if (m_format == OutputFormat::JsonLines) {
+		static constexpr char HEX[] { "0123456789abcdef" };
+		m_buffer.push_back('"');
+		for (char c : text) {
+			unsigned char byte { static_cast<unsigned char>(c) };
+			if (c == '"' || c == '\\') {
+				m_buffer.push_back('\\');
+				m_buffer.push_back(c);
+			} else if (byte < 0x20) {
+				m_buffer.append("\\u00");
+				m_buffer.push_back(HEX[byte >> 4]);
+				m_buffer.push_back(HEX[byte & 0xf]);
+			} else {
+				m_buffer.push_back(c);
+			}
+		}
+		m_buffer.push_back('"');
+	} else if (m_format == OutputFormat::Csv && text.find_first_of(",\"\r\n") != std::string_view::npos) {
+		m_buffer.push_back('"');
+		for (char c : text) {
+			if (c == '"') {
+				m_buffer.push_back('"');
+			}
+			m_buffer.push_back(c);
+		}
+		m_buffer.push_back('"');
+	} else {
+		m_buffer.append(text);
+	}
+}
+
+/**
+ * Write the buffer to the stream without flushing it, keeping the
+ * buffer's capacity for the next records. A caller's string keeps
+ * growing until the caller consumes it.
+ */
+void CourseWriter::drain() {
+	if (m_os != nullptr && !m_buffer.empty()) {
+		m_os->write(m_buffer.data(), static_cast<std::streamsize>(m_buffer.size()));
+		m_buffer.clear();
+	}
+}
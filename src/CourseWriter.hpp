@@ -0,0 +1,75 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include "Course.hpp"
+
+enum class OutputFormat {
+	Text, // the menu's "Number: / Title: / Prerequisites:" blocks
+	JsonLines, // one {"number", "title", "prerequisites"} object per line
+	Csv // number,title,prerequisites... like the input file
+};
+
+bool ParseOutputFormat(std::string_view text, OutputFormat &format);
+
+/*
+ * Buffered course output
+ *
+ * Records are formatted into one reusable buffer that is handed to the
+ * stream whenever it passes BUFFER_SIZE, and the stream is flushed once,
+ * by flush() or the destructor. Listing a large catalog costs a handful
+ * of stream writes instead of a flush per line, and once the buffer has
+ * grown nothing is allocated per course. A writer can also append to a
+ * caller's string instead, such as a connection's send buffer.
+ */
+class CourseWriter {
+	private:
+		std::ostream *m_os; // nullptr when writing to a caller's string
+		OutputFormat m_format;
+		std::string m_own;
+		std::string &m_buffer; // m_own, or the caller's string
+		std::size_t m_count { };
+		void begin(std::string_view number, std::string_view title);
+		void prerequisite(std::string_view number, const std::size_t &i);
+		void end();
+		void appendQuoted(std::string_view text);
+		void drain();
+
+	public:
+		static constexpr std::size_t BUFFER_SIZE { 1 << 16 };
+		CourseWriter(std::ostream &t_os, const OutputFormat &t_format = OutputFormat::Text);
+		CourseWriter(std::string &t_target, const OutputFormat &t_format = OutputFormat::Text);
+		CourseWriter(const CourseWriter &) = delete;
+		CourseWriter &operator=(const CourseWriter &) = delete;
+		~CourseWriter();
+		void write(const Course &course);
+		template <typename Prerequisites>
+		void write(std::string_view number, std::string_view title, const Prerequisites &prerequisites);
+		void term(const std::uint32_t &term, std::string_view number);
+		void error(std::string_view message);
+		void line(std::string_view text);
+		void flush();
+		std::size_t count() const;
+		OutputFormat format() const;
+		void format(const OutputFormat &t_format);
+};
+
+/**
+ * Write one course given as its parts, for records that are not a Course
+ *
+ * @param number The course number
+ * @param title The course title
+ * @param prerequisites A range of prerequisite numbers, each convertible
+ *        to std::string_view
+ */
+template <typename Prerequisites>
+void CourseWriter::write(std::string_view number, std::string_view title, const Prerequisites &prerequisites) {
+	begin(number, title);
+	std::size_t i { };
+	for (const auto &prerequisite : prerequisites) {
+		this->prerequisite(std::string_view { prerequisite }, i++);
+	}
+	end();
+}
@@ -0,0 +1,231 @@
+#include "CsvLoader.hpp"
+
+/**
+ * Split one line of a course CSV into fields with std::string_view::find.
+ * Empty fields are skipped and a trailing carriage return is dropped.
+ *
+ * @param line The line, without its newline
+ * @param row Receives the fields
+ */
+void SplitRow(std::string_view line, CsvRow &row) {
+	const char COL_DEL { ',' };
+	ResetRow(row);
+	// iter by column
+	std::size_t start { };
+	while (start <= line.size()) {
+		std::size_t end { line.find(COL_DEL, start) };
+		bool last { end == std::string_view::npos };
+		if (last) {
+			end = line.size();
+		}
+		AddField(row, line.substr(start, end - start), last);
+		start = end + 1;
+	}
+}
+
+/**
+ * Cut data into count pieces that each end on a newline
+ *
+ * @param data The file contents
+ * @param count The number of pieces wanted, fewer are returned if rows are long
+ * @return The chunks, in file order
+ */
+std::vector<csv_detail::Chunk> csv_detail::SplitChunks(std::string_view data, const std::size_t &count) {
+	std::vector<Chunk> chunks;
+	std::size_t target { data.size() / std::max<std::size_t>(count, 1) };
+	for (std::size_t start { }; start < data.size(); ) {
+		std::size_t end { data.size() };
+		if (chunks.size() + 1 < count) {
+			end = data.find('\n', start + target);
+			end = end == std::string_view::npos ? data.size() : end + 1;
+		}
+		chunks.emplace_back().data = data.substr(start, end - start);
+		start = end;
+	}
+	return chunks;
+}
+
+/**
+ * Parse one chunk into row views over its data.
+ * Line numbers are relative to the start of the chunk.
+ *
+ * @param chunk The chunk to parse
+ */
+void csv_detail::ParseChunk(Chunk &chunk) {
+	TokenizeRows(chunk.data, [&](const CsvRow &row, std::size_t line) {
+		chunk.lines = line;
+		// check for min number of fields
+		if (row.field_count < 2) {
+			chunk.errors.push_back({ line, MinFieldsMessage(row.field_count) });
+			return;
+		}
+		chunk.rows.push_back({ row.number, row.title, static_cast<std::uint32_t>(chunk.prerequisites.size()), static_cast<std::uint32_t>(row.prerequisites.size()), line });
+		chunk.prerequisites.insert(chunk.prerequisites.end(), row.prerequisites.begin(), row.prerequisites.end());
+	});
+}
+
+/**
+ * Build an owning Course for every parsed row of a chunk
+ *
+ * @param chunk A parsed chunk
+ */
+void csv_detail::MakeCourses(Chunk &chunk) {
+	chunk.courses.reserve(chunk.rows.size());
+	for (const RowView &row : chunk.rows) {
+		Course course { std::string { row.number }, std::string { row.title }, { } };
+		course.prerequisites.assign(chunk.prerequisites.begin() + row.prerequisites_begin, chunk.prerequisites.begin() + row.prerequisites_begin + row.prerequisites_count);
+		chunk.courses.push_back(std::move(course));
+	}
+}
+
+/**
+ * Load and validate a course CSV into an arena backed catalog.
+ * Rows are parsed as views exactly as in LoadCatalog, then numbers are
+ * interned to ids, titles into the catalog's pool, and all prerequisite
+ * id lists are carved out of one shared array. Validation compares ids.
+ *
+ * @param file_path Path to the CSV
+ * @param options Thread count
+ * @return The loaded catalog, the number of rows and all errors found
+ */
+LoadResult<CourseArena> LoadCourseArena(const std::string &file_path, const LoadOptions &options) {
+	CSC300_TIME(Load);
+	return csv_detail::Load<CourseArena>(file_path, options, false, [](CourseArena &catalog, std::vector<csv_detail::Chunk> &chunks) {
+		std::size_t rows { }, total { };
+		for (const csv_detail::Chunk &chunk : chunks) {
+			rows += chunk.rows.size();
+			total += chunk.prerequisites.size();
+		}
+		catalog.reserve(rows);
+		catalog.strings().reserve(rows);
+		std::span<std::uint32_t> shared { catalog.allocatePrerequisites(total) };
+		std::size_t next { };
+		// merge in file order
+		for (csv_detail::Chunk &chunk : chunks) {
+			chunk.prerequisite_ids.resize(chunk.prerequisites.size());
+			for (const csv_detail::RowView &row : chunk.rows) {
+				std::span<std::uint32_t> prerequisites { shared.subspan(next, row.prerequisites_count) };
+				for (std::uint32_t i = 0; i < row.prerequisites_count; ++i) {
+					prerequisites[i] = catalog.ids().intern(chunk.prerequisites[row.prerequisites_begin + i]);
+					chunk.prerequisite_ids[row.prerequisites_begin + i] = prerequisites[i];
+				}
+				next += row.prerequisites_count;
+				catalog.insert(row.number, row.title, prerequisites);
+			}
+		}
+	}, [](const CourseArena &catalog, const csv_detail::RowView &row, csv_detail::Chunk &chunk) {
+		for (std::uint32_t p = row.prerequisites_begin; p < row.prerequisites_begin + row.prerequisites_count; ++p) {
+			if (!catalog.defined(chunk.prerequisite_ids[p])) {
+				chunk.errors.push_back({ row.line, MissingPrerequisiteMessage(chunk.prerequisites[p]) });
+			}
+		}
+	});
+}
+
+/**
+ * Load and validate a course CSV into a columnar catalog. Rows are
+ * parsed as views exactly as in LoadCatalog, then appended to the
+ * columns in file order; validation checks the defined column.
+ *
+ * @param file_path Path to the CSV
+ * @param options Thread count
+ * @return The loaded catalog, the number of rows and all errors found
+ */
+LoadResult<CourseColumns> LoadCourseColumns(const std::string &file_path, const LoadOptions &options) {
+	CSC300_TIME(Load);
+	return csv_detail::Load<CourseColumns>(file_path, options, false, [](CourseColumns &catalog, std::vector<csv_detail::Chunk> &chunks) {
+		std::size_t rows { };
+		for (const csv_detail::Chunk &chunk : chunks) {
+			rows += chunk.rows.size();
+		}
+		catalog.reserve(rows);
+		// merge in file order
+		for (csv_detail::Chunk &chunk : chunks) {
+			chunk.prerequisite_ids.resize(chunk.prerequisites.size());
+			for (const csv_detail::RowView &row : chunk.rows) {
+				for (std::uint32_t p = row.prerequisites_begin; p < row.prerequisites_begin + row.prerequisites_count; ++p) {
+					chunk.prerequisite_ids[p] = catalog.intern(chunk.prerequisites[p]);
+				}
+				catalog.insert(row.number, row.title, std::span<const std::uint32_t> { chunk.prerequisite_ids.data() + row.prerequisites_begin, row.prerequisites_count });
+			}
+		}
+	}, [](const CourseColumns &catalog, const csv_detail::RowView &row, csv_detail::Chunk &chunk) {
+		for (std::uint32_t p = row.prerequisites_begin; p < row.prerequisites_begin + row.prerequisites_count; ++p) {
+			if (!catalog.defined(chunk.prerequisite_ids[p])) {
+				chunk.errors.push_back({ row.line, MissingPrerequisiteMessage(chunk.prerequisites[p]) });
+			}
+		}
+	});
+}
+
+/**
+ * Check a course CSV without building a catalog. Rows are parsed and
+ * checked concurrently like LoadCatalog, but only course numbers are
+ * kept, interned into a CourseIds set, and prerequisites are looked up
+ * in it. Every error is collected in one pass, none is printed.
+ *
+ * @param file_path Path to the CSV
+ * @param options Thread count
+ * @return The number of rows and courses and all errors found
+ */
+ValidationReport ValidateCatalog(const std::string &file_path, const LoadOptions &options) {
+	CSC300_TIME(Validate);
+	LoadResult<CourseIds> loaded { csv_detail::Load<CourseIds>(file_path, options, false, [](CourseIds &numbers, std::vector<csv_detail::Chunk> &chunks) {
+		std::size_t rows { };
+		for (const csv_detail::Chunk &chunk : chunks) {
+			rows += chunk.rows.size();
+		}
+		numbers.reserve(rows);
+		for (const csv_detail::Chunk &chunk : chunks) {
+			for (const csv_detail::RowView &row : chunk.rows) {
+				numbers.intern(row.number);
+			}
+		}
+	}, [](const CourseIds &numbers, const csv_detail::RowView &row, csv_detail::Chunk &chunk) {
+		for (std::uint32_t p = row.prerequisites_begin; p < row.prerequisites_begin + row.prerequisites_count; ++p) {
+			if (numbers.find(chunk.prerequisites[p]) == CourseIds::INVALID) {
+				chunk.errors.push_back({ row.line, MissingPrerequisiteMessage(chunk.prerequisites[p]) });
+			}
+		}
+	}) };
+	return { loaded.row_count, loaded.table.size(), std::move(loaded.errors), loaded.opened };
+}
+
+/**
+ * Validate the formatting of a comma separated list of courses
+ * Prints every error found, ValidateCatalog returns them as a report
+ *
+ * @param file_path Path to the CSV
+ * @return int if bad formatting: -1, otherwise: the number of rows in the CSV
+ */
+int ValidateFile(const std::string &file_path) {
+	ValidationReport report { ValidateCatalog(file_path, { DefaultThreadCount() }) };
+	for (const LoadError &error : report.errors) {
+		std::cout << error << std::endl;
+	}
+	return report.ok() ? report.row_count : -1;
+}
+
+/**
+ * @param field_count The number of fields found on the row
+ * @return The error reported for a row without a number and title
+ */
+std::string MinFieldsMessage(const int &field_count) {
+	return "There must be at minimum a course number and title, but only " + std::to_string(field_count) + " values were found.";
+}
+
+/**
+ * @param prerequisite The prerequisite that has no row
+ * @return The error reported for a prerequisite without a course
+ */
+std::string MissingPrerequisiteMessage(std::string_view prerequisite) {
+	return "No entry found for listed prerequisite: " + std::string { prerequisite };
+}
+
+/**
+ * @param buffer_size The stream buffer size
+ * @return The error reported for a row that does not fit the buffer
+ */
+std::string LongRowMessage(const std::size_t &buffer_size) {
+	return "Row is longer than the " + std::to_string(buffer_size) + " byte read buffer and was skipped.";
+}
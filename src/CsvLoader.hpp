@@ -0,0 +1,312 @@
+#pragma once
+#include <string>
+#include <string_view>
+#include <vector>
+#include <algorithm>
+#include <iostream>
+#include "Course.hpp"
+#include "HashTable.hpp"
+#include "MappedFile.hpp"
+#include "DelimiterScan.hpp"
+#include "Parallel.hpp"
+#include "CourseArena.hpp"
+#include "CourseColumns.hpp"
+
+/*
+ * Single pass course CSV loader
+ *
+ * The file is memory mapped and split in place into std::string_view
+ * fields; strings are only allocated for the Course objects handed to
+ * the table. Delimiters are located with the vectorized ScanDelimiters,
+ * one block at a time. Prerequisites are checked against the table once every row
+ * is in, so loading and validation share one read of the file.
+ *
+ * row description: number,title,prerequisite 1,prerequisite 2,etc.
+ */
+
+/*
+ * A row of a course CSV, fields point into the source buffer
+ */
+struct CsvRow {
+	std::string_view number;
+	std::string_view title;
+	std::vector<std::string_view> prerequisites; // reused across rows to avoid reallocating
+	int field_count { };
+};
+
+/*
+ * A problem found in a course CSV
+ */
+struct LoadError {
+	std::size_t line { }; // 1 based, 0 if not tied to a line
+	std::string message;
+	friend std::ostream &operator<<(std::ostream &os, const LoadError &error) {
+		if (error.line > 0) {
+			os << "line " << error.line << ": ";
+		}
+		return os << error.message;
+	}
+};
+
+/*
+ * Everything a load produces: the table, the number of rows and any errors
+ */
+template <typename Table = HashTable<>>
+struct LoadResult {
+	Table table;
+	int row_count { };
+	std::vector<LoadError> errors;
+	bool opened { false };
+	std::uint64_t source_hash { }; // WyHash of the bytes parsed, with LoadOptions::hash_source
+	bool ok() const {
+		return opened && errors.empty();
+	}
+};
+
+/*
+ * Outcome of validating a course CSV without keeping the courses
+ */
+struct ValidationReport {
+	int row_count { }; // rows with at least a number and title
+	std::size_t course_count { }; // distinct course numbers
+	std::vector<LoadError> errors; // every problem found, in file order
+	bool opened { false };
+	bool ok() const {
+		return opened && errors.empty();
+	}
+};
+
+void SplitRow(std::string_view line, CsvRow &row);
+
+/*
+ * Clear a row before reading the next one
+ */
+inline void ResetRow(CsvRow &row) {
+	row.number = { };
+	row.title = { };
+	row.prerequisites.clear();
+	row.field_count = 0;
+}
+
+/*
+ * Add the next field of a row. Empty fields are skipped and a trailing
+ * carriage return is dropped from the last field of the row.
+ *
+ * @param row The row being built
+ * @param field The field
+ * @param last true if field ends the row
+ */
+inline void AddField(CsvRow &row, std::string_view field, const bool &last) {
+	if (last && !field.empty() && field.back() == '\r') {
+		field.remove_suffix(1);
+	}
+	// skip empty fields
+	if (field.empty()) {
+		return;
+	}
+	// determine field type
+	switch(row.field_count) {
+	case 0: // course number
+		row.number = field;
+		break;
+	case 1: // course title
+		row.title = field;
+		break;
+	default: // course prerequisite
+		row.prerequisites.push_back(field);
+		break;
+	}
+	++row.field_count;
+}
+
+/*
+ * Split a buffer of CSV rows into fields and hand each row to on_row.
+ * The buffer is scanned for delimiters in blocks that end on a newline,
+ * so the offset array stays small and cache resident.
+ *
+ * @param data The rows
+ * @param on_row Called as on_row(const CsvRow &, std::size_t line) for every row
+ * @param first_line Line number of the first row in data
+ */
+template <typename OnRow>
+void TokenizeRows(std::string_view data, OnRow &&on_row, std::size_t first_line = 1) {
+	const std::size_t BLOCK_SIZE { 1 << 20 };
+	std::vector<std::uint32_t> delimiters;
+	CsvRow row;
+	std::size_t line { first_line };
+	for (std::size_t start { }; start < data.size(); ) {
+		std::size_t end { std::min(start + BLOCK_SIZE, data.size()) };
+		// end the block after its last newline so no row straddles two blocks
+		if (end < data.size()) {
+			std::size_t last { data.rfind('\n', end - 1) };
+			if (last == std::string_view::npos || last < start) {
+				last = data.find('\n', end); // row longer than a block
+			}
+			end = last == std::string_view::npos ? data.size() : last + 1;
+		}
+		std::string_view block { data.substr(start, end - start) };
+		start = end;
+		delimiters.clear();
+		ScanDelimiters(block, delimiters);
+		ResetRow(row);
+		std::size_t field_start { };
+		for (std::uint32_t offset : delimiters) {
+			bool row_end { block[offset] == '\n' };
+			AddField(row, block.substr(field_start, offset - field_start), row_end);
+			field_start = offset + 1;
+			if (row_end) {
+				on_row(static_cast<const CsvRow &>(row), line++);
+				ResetRow(row);
+			}
+		}
+		// last row of the file without a newline
+		if (block.back() != '\n') {
+			AddField(row, block.substr(field_start), true);
+			on_row(static_cast<const CsvRow &>(row), line++);
+		}
+	}
+}
+std::string MinFieldsMessage(const int &field_count);
+std::string MissingPrerequisiteMessage(std::string_view prerequisite);
+
+/*
+ * Options for LoadCatalog
+ */
+struct LoadOptions {
+	// threads parsing and validating chunks of the file; files too
+	// small to split into MIN_CHUNK_SIZE chunks are loaded on one thread
+	unsigned int threads { 1 };
+	// hash the mapped file into LoadResult::source_hash, for snapshots
+	bool hash_source { false };
+	static constexpr std::size_t MIN_CHUNK_SIZE { 1 << 20 };
+};
+
+namespace csv_detail {
+	// a row of the file as views into the mapping
+	struct RowView {
+		std::string_view number;
+		std::string_view title;
+		std::uint32_t prerequisites_begin; // index into Chunk::prerequisites
+		std::uint32_t prerequisites_count;
+		std::size_t line;
+	};
+
+	// one newline aligned piece of the file and everything parsed from it
+	struct Chunk {
+		std::string_view data;
+		std::vector<RowView> rows;
+		std::vector<std::string_view> prerequisites; // every row's prerequisites back to back
+		std::vector<std::uint32_t> prerequisite_ids; // ids of prerequisites, for catalogs that intern them
+		std::vector<Course> courses; // rows as owning courses, filled by MakeCourses
+		std::vector<LoadError> errors;
+		std::size_t lines { }; // rows in data, used to offset later chunks' line numbers
+	};
+
+	std::vector<Chunk> SplitChunks(std::string_view data, const std::size_t &count);
+	void ParseChunk(Chunk &chunk);
+	void MakeCourses(Chunk &chunk);
+
+	/*
+	 * Map, split, parse, merge and validate a course CSV
+	 *
+	 * @param file_path Path to the CSV
+	 * @param options Thread count
+	 * @param make_courses Build owning Courses for each chunk while parsing
+	 * @param merge Called as merge(Table &, std::vector<Chunk> &) once every chunk is parsed
+	 * @param validate Called as validate(const Table &, const RowView &, Chunk &) for every row of
+	 * the merged chunks, concurrently for different chunks; appends errors to the chunk
+	 */
+	template <typename Table, typename Merge, typename Validate>
+	LoadResult<Table> Load(const std::string &file_path, const LoadOptions &options, const bool &make_courses, Merge &&merge, Validate &&validate) {
+		LoadResult<Table> result;
+		MappedFile csv { file_path };
+		if (!csv.is_open()) {
+			result.errors.push_back({ 0, "Failed to open file: " + file_path });
+			return result;
+		}
+		result.opened = true;
+		std::string_view data { csv.view() };
+		if (options.hash_source) {
+			result.source_hash = WyHash {}(data);
+		}
+		// several chunks per thread so a slow chunk doesn't hold up the rest
+		std::size_t chunk_count { std::min<std::size_t>(options.threads * 4, data.size() / LoadOptions::MIN_CHUNK_SIZE) };
+		std::vector<Chunk> chunks { SplitChunks(data, options.threads > 1 ? chunk_count : 1) };
+		ParallelFor(chunks.size(), options.threads, [&](std::size_t i) {
+			ParseChunk(chunks[i]);
+			if (make_courses) {
+				MakeCourses(chunks[i]);
+			}
+		});
+		// fix up chunk local line numbers
+		std::size_t first_line { };
+		for (Chunk &chunk : chunks) {
+			for (LoadError &error : chunk.errors) {
+				error.line += first_line;
+			}
+			for (RowView &row : chunk.rows) {
+				row.line += first_line;
+			}
+			first_line += chunk.lines;
+			result.row_count += chunk.rows.size();
+		}
+		merge(result.table, chunks);
+		// the table is read only from here on, safe to share between threads
+		ParallelFor(chunks.size(), options.threads, [&](std::size_t i) {
+			for (const RowView &row : chunks[i].rows) {
+				validate(static_cast<const Table &>(result.table), row, chunks[i]);
+			}
+		});
+		for (Chunk &chunk : chunks) {
+			result.errors.insert(result.errors.end(), std::make_move_iterator(chunk.errors.begin()), std::make_move_iterator(chunk.errors.end()));
+		}
+		// report in file order
+		std::stable_sort(result.errors.begin(), result.errors.end(), [](const LoadError &a, const LoadError &b) {
+			return a.line < b.line;
+		});
+		return result;
+	}
+}
+
+/*
+ * Load and validate a course CSV in a single pass
+ *
+ * With more than one thread the file is cut into newline aligned
+ * chunks that are parsed concurrently into per chunk buffers. The
+ * buffers are merged into the table in file order (so later rows
+ * still replace earlier ones with the same number), then the
+ * prerequisite check runs concurrently against the finished table.
+ *
+ * @param file_path Path to the CSV
+ * @param options Thread count
+ * @return The loaded table, the number of rows and all errors found
+ */
+template <typename Hash = WyHash>
+LoadResult<HashTable<Hash>> LoadCatalog(const std::string &file_path, const LoadOptions &options = { }) {
+	CSC300_TIME(Load);
+	return csv_detail::Load<HashTable<Hash>>(file_path, options, true, [](HashTable<Hash> &table, std::vector<csv_detail::Chunk> &chunks) {
+		std::size_t rows { };
+		for (const csv_detail::Chunk &chunk : chunks) {
+			rows += chunk.courses.size();
+		}
+		table.reserve(rows);
+		// merge in file order
+		for (csv_detail::Chunk &chunk : chunks) {
+			for (Course &course : chunk.courses) {
+				table.insert(std::move(course));
+			}
+			chunk.courses = { };
+		}
+	}, [](const HashTable<Hash> &table, const csv_detail::RowView &row, csv_detail::Chunk &chunk) {
+		for (std::uint32_t p = row.prerequisites_begin; p < row.prerequisites_begin + row.prerequisites_count; ++p) {
+			if (!table.contains(chunk.prerequisites[p])) {
+				chunk.errors.push_back({ row.line, MissingPrerequisiteMessage(chunk.prerequisites[p]) });
+			}
+		}
+	});
+}
+
+LoadResult<CourseArena> LoadCourseArena(const std::string &file_path, const LoadOptions &options = { });
+LoadResult<CourseColumns> LoadCourseColumns(const std::string &file_path, const LoadOptions &options = { });
+ValidationReport ValidateCatalog(const std::string &file_path, const LoadOptions &options = { });
+int ValidateFile(const std::string &file_path);
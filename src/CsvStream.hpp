@@ -0,0 +1,111 @@
+#pragma once
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <string_view>
+#include "CsvLoader.hpp"
+
+/*
+ * Bounded memory course CSV reader
+ *
+ * Reads the file through one fixed size buffer and hands every parsed
+ * row to a sink as it goes, so memory use depends on the buffer size and
+ * not on the file size. Rows are split with TokenizeRows exactly like
+ * LoadCatalog, and rows without a number and title are reported with
+ * the same messages. Prerequisites are not checked: that needs every
+ * course number, which is up to the sink to keep if it wants to.
+ */
+
+/*
+ * Options for StreamCatalog
+ */
+struct StreamOptions {
+	// bytes read at a time, the peak memory used for file data;
+	// a row longer than this is reported as an error and skipped
+	std::size_t buffer_size { 1 << 20 };
+	static constexpr std::size_t MIN_BUFFER_SIZE { 64 };
+};
+
+/*
+ * Totals of a streamed read, the rows and errors themselves went to the sink
+ */
+struct StreamResult {
+	int row_count { }; // rows handed to on_row
+	std::size_t error_count { }; // errors handed to on_error
+	bool opened { false };
+	bool ok() const {
+		return opened && error_count == 0;
+	}
+};
+
+std::string LongRowMessage(const std::size_t &buffer_size);
+
+/*
+ * Stream a course CSV through a sink
+ *
+ * The row's fields view the read buffer and are only valid during the
+ * call; copy whatever has to outlive it. on_row may feed a table, an
+ * on disk index, a filter, or anything else taking rows one at a time.
+ *
+ * @param file_path Path to the CSV
+ * @param on_row Called as on_row(const CsvRow &, std::size_t line) for every well formed row, in file order
+ * @param on_error Called as on_error(const LoadError &) for every problem found, in file order
+ * @param options Buffer size
+ * @return Row and error counts
+ */
+template <typename OnRow, typename OnError>
+StreamResult StreamCatalog(const std::string &file_path, OnRow &&on_row, OnError &&on_error, const StreamOptions &options = { }) {
+	StreamResult result;
+	std::ifstream csv { file_path, std::ios::binary };
+	if (!csv.is_open()) {
+		++result.error_count;
+		on_error(LoadError { 0, "Failed to open file: " + file_path });
+		return result;
+	}
+	result.opened = true;
+	std::string buffer(std::max(options.buffer_size, StreamOptions::MIN_BUFFER_SIZE), '\0');
+	std::size_t filled { }; // bytes of buffer holding unread rows
+	std::size_t line { 1 };
+	bool skipping { false }; // inside a row too long for the buffer
+	for (bool eof { false }; !eof; ) {
+		csv.read(buffer.data() + filled, static_cast<std::streamsize>(buffer.size() - filled));
+		std::size_t got { static_cast<std::size_t>(csv.gcount()) };
+		eof = got == 0 || !csv;
+		filled += got;
+		std::string_view data { buffer.data(), filled };
+		std::size_t begin { };
+		if (skipping) {
+			std::size_t newline { data.find('\n') };
+			if (newline == std::string_view::npos) {
+				filled = 0;
+				continue;
+			}
+			skipping = false;
+			begin = newline + 1;
+			++line;
+		}
+		// hand over complete rows only, the rest waits for the next read
+		std::size_t end { data.rfind('\n') };
+		end = eof ? filled : (end == std::string_view::npos || end < begin ? begin : end + 1);
+		if (end == begin && filled - begin == buffer.size()) {
+			++result.error_count;
+			on_error(LoadError { line, LongRowMessage(buffer.size()) });
+			skipping = true;
+			filled = 0;
+			continue;
+		}
+		TokenizeRows(data.substr(begin, end - begin), [&](const CsvRow &row, std::size_t row_line) {
+			line = row_line + 1;
+			if (row.field_count < 2) {
+				++result.error_count;
+				on_error(LoadError { row_line, MinFieldsMessage(row.field_count) });
+				return;
+			}
+			++result.row_count;
+			on_row(row, row_line);
+		}, line);
+		std::memmove(buffer.data(), buffer.data() + end, filled - end);
+		filled -= end;
+	}
+	return result;
+}
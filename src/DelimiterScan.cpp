@@ -0,0 +1,129 @@
+#include "DelimiterScan.hpp"
+#include <bit>
+// the x86 path needs GCC or Clang for target attributes and cpu checks,
+// other compilers get the scalar scan
+#if (defined(__x86_64__) || defined(__SSE2__)) && (defined(__GNUC__) || defined(__clang__))
+#include <immintrin.h>
+#define CSC300_SCAN_X86 1
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#define CSC300_SCAN_NEON 1
+#endif
+
+namespace {
+	using ScanFn = void (*)(std::string_view, std::vector<std::uint32_t> &);
+
+	// append the offset of every set bit in mask, relative to base
+	inline void emitMask(std::uint64_t mask, std::uint32_t base, std::vector<std::uint32_t> &offsets) {
+		while (mask != 0) {
+			offsets.push_back(base + static_cast<std::uint32_t>(std::countr_zero(mask)));
+			mask &= mask - 1; // clear lowest set bit
+		}
+	}
+
+	// scalar scan of data[from, end), used for tails
+	inline void scanTail(std::string_view data, std::size_t from, std::vector<std::uint32_t> &offsets) {
+		for (std::size_t i { from }; i < data.size(); ++i) {
+			if (data[i] == ',' || data[i] == '\n') {
+				offsets.push_back(static_cast<std::uint32_t>(i));
+			}
+		}
+	}
+
+#ifdef CSC300_SCAN_X86
+	void scanSse2(std::string_view data, std::vector<std::uint32_t> &offsets) {
+		const __m128i COMMA { _mm_set1_epi8(',') }, NEWLINE { _mm_set1_epi8('\n') };
+		std::size_t i { };
+		for (; i + 16 <= data.size(); i += 16) {
+			__m128i chunk { _mm_loadu_si128(reinterpret_cast<const __m128i *>(data.data() + i)) };
+			__m128i hits { _mm_or_si128(_mm_cmpeq_epi8(chunk, COMMA), _mm_cmpeq_epi8(chunk, NEWLINE)) };
+			emitMask(static_cast<std::uint32_t>(_mm_movemask_epi8(hits)), static_cast<std::uint32_t>(i), offsets);
+		}
+		scanTail(data, i, offsets);
+	}
+
+	__attribute__((target("avx2")))
+	void scanAvx2(std::string_view data, std::vector<std::uint32_t> &offsets) {
+		const __m256i COMMA { _mm256_set1_epi8(',') }, NEWLINE { _mm256_set1_epi8('\n') };
+		std::size_t i { };
+		// two registers per step so one 64 bit mask covers 64 bytes
+		for (; i + 64 <= data.size(); i += 64) {
+			__m256i lo { _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data.data() + i)) };
+			__m256i hi { _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data.data() + i + 32)) };
+			std::uint64_t lo_mask { static_cast<std::uint32_t>(_mm256_movemask_epi8(
+				_mm256_or_si256(_mm256_cmpeq_epi8(lo, COMMA), _mm256_cmpeq_epi8(lo, NEWLINE)))) };
+			std::uint64_t hi_mask { static_cast<std::uint32_t>(_mm256_movemask_epi8(
+				_mm256_or_si256(_mm256_cmpeq_epi8(hi, COMMA), _mm256_cmpeq_epi8(hi, NEWLINE)))) };
+			emitMask(lo_mask | (hi_mask << 32), static_cast<std::uint32_t>(i), offsets);
+		}
+		scanTail(data, i, offsets);
+	}
+#endif
+
+#ifdef CSC300_SCAN_NEON
+	void scanNeon(std::string_view data, std::vector<std::uint32_t> &offsets) {
+		const uint8x16_t COMMA { vdupq_n_u8(',') }, NEWLINE { vdupq_n_u8('\n') };
+		std::size_t i { };
+		for (; i + 16 <= data.size(); i += 16) {
+			uint8x16_t chunk { vld1q_u8(reinterpret_cast<const std::uint8_t *>(data.data() + i)) };
+			uint8x16_t hits { vorrq_u8(vceqq_u8(chunk, COMMA), vceqq_u8(chunk, NEWLINE)) };
+			// narrow to 4 bits per byte, NEON has no movemask
+			std::uint64_t nibbles { vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(hits), 4)), 0) };
+			while (nibbles != 0) {
+				offsets.push_back(static_cast<std::uint32_t>(i + (std::countr_zero(nibbles) >> 2)));
+				nibbles &= ~(0xfull << (std::countr_zero(nibbles) & ~3));
+			}
+		}
+		scanTail(data, i, offsets);
+	}
+#endif
+
+	struct Scanner {
+		ScanFn scan;
+		const char *name;
+	};
+
+	// pick the implementation once
+	const Scanner &selected() {
+		static const Scanner scanner { [] () -> Scanner {
+#ifdef CSC300_SCAN_X86
+			if (__builtin_cpu_supports("avx2")) {
+				return { scanAvx2, "avx2" };
+			}
+			return { scanSse2, "sse2" };
+#elif defined(CSC300_SCAN_NEON)
+			return { scanNeon, "neon" };
+#else
+			return { ScanDelimitersScalar, "scalar" };
+#endif
+		}() };
+		return scanner;
+	}
+}
+
+/**
+ * Find every ',' and '\n' in data using the best available instruction set
+ *
+ * @param data The bytes to scan, smaller than 4 GiB
+ * @param offsets Receives the offset of each delimiter
+ */
+void ScanDelimiters(std::string_view data, std::vector<std::uint32_t> &offsets) {
+	selected().scan(data, offsets);
+}
+
+/**
+ * Find every ',' and '\n' in data one byte at a time
+ *
+ * @param data The bytes to scan, smaller than 4 GiB
+ * @param offsets Receives the offset of each delimiter
+ */
+void ScanDelimitersScalar(std::string_view data, std::vector<std::uint32_t> &offsets) {
+	scanTail(data, 0, offsets);
+}
+
+/**
+ * @return Name of the implementation ScanDelimiters uses
+ */
+const char *ScanDelimitersName() {
+	return selected().name;
+}
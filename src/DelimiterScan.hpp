@@ -0,0 +1,18 @@
+#pragma once
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+/*
+ * Vectorized search for the CSV delimiters ',' and '\n'
+ *
+ * Each function appends the offset of every delimiter in data to
+ * offsets, in order. data must be smaller than 4 GiB; callers scan
+ * large files block by block. ScanDelimiters picks the widest
+ * implementation the CPU supports (AVX2, SSE2 or NEON) at first use and
+ * falls back to ScanDelimitersScalar.
+ */
+
+void ScanDelimiters(std::string_view data, std::vector<std::uint32_t> &offsets);
+void ScanDelimitersScalar(std::string_view data, std::vector<std::uint32_t> &offsets);
+const char *ScanDelimitersName();
@@ -0,0 +1,140 @@
+#include "Epoch.hpp"
+#include <algorithm>
+#include <thread>
+
+namespace {
+	// process wide thread indices, so each thread owns one slot in every domain
+	std::atomic<bool> g_claimed[EpochDomain::MAX_THREADS];
+
+	struct ThreadIndex {
+		std::size_t index { };
+		ThreadIndex() {
+			// with every index taken, wait for a thread to exit
+			for (;;) {
+				for (std::size_t i = 0; i < EpochDomain::MAX_THREADS; ++i) {
+					if (!g_claimed[i].load(std::memory_order_relaxed) && !g_claimed[i].exchange(true, std::memory_order_acquire)) {
+						index = i;
+						return;
+					}
+				}
+				std::this_thread::yield();
+			}
+		}
+		~ThreadIndex() {
+			g_claimed[index].store(false, std::memory_order_release);
+		}
+	};
+
+	std::size_t threadIndex() {
+		thread_local ThreadIndex thread;
+		return thread.index;
+	}
+}
+
+/**
+ * Pin the domain on the calling thread, nested pins are allowed
+ *
+ * @param t_domain The domain to pin
+ */
+EpochDomain::Guard::Guard(EpochDomain &t_domain) : m_domain(&t_domain), m_slot(threadIndex()) {
+	Slot &slot { m_domain->m_slots[m_slot] };
+	if (slot.depth++ == 0) {
+		slot.epoch.store(m_domain->m_epoch.load(std::memory_order_acquire), std::memory_order_relaxed);
+		// the announcement must be visible before any published pointer is read
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+	}
+}
+
+EpochDomain::Guard::~Guard() {
+	Slot &slot { m_domain->m_slots[m_slot] };
+	if (--slot.depth == 0) {
+		slot.epoch.store(IDLE, std::memory_order_release);
+	}
+}
+
+/**
+ * Destroy everything still retired. No reader may be pinned.
+ */
+EpochDomain::~EpochDomain() {
+	for (Retired &retired : m_retired) {
+		retired.destroy();
+	}
+}
+
+/**
+ * @return A guard pinning the domain on the calling thread
+ */
+EpochDomain::Guard EpochDomain::pin() {
+	return Guard { *this };
+}
+
+/**
+ * @return The earliest epoch a reader is pinned at, IDLE if none is
+ */
+std::uint64_t EpochDomain::oldestPinned() const {
+	// pairs with the fence in Guard: either a reader's pin is seen here or
+	// that reader sees whatever was published before this scan
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	std::uint64_t oldest { IDLE };
+	for (std::size_t i = 0; i < MAX_THREADS; ++i) {
+		oldest = std::min(oldest, m_slots[i].epoch.load(std::memory_order_acquire));
+	}
+	return oldest;
+}
+
+/**
+ * Hand over an object that was just unpublished. It is destroyed once
+ * every reader pinned before now has unpinned.
+ *
+ * @param destroy Deletes the object
+ */
+void EpochDomain::retire(std::function<void()> destroy) {
+	// readers pinned from here on cannot reach the unpublished object
+	std::uint64_t epoch { m_epoch.fetch_add(1, std::memory_order_seq_cst) };
+	{
+		std::lock_guard<std::mutex> lock { m_retired_mutex };
+		m_retired.push_back({ epoch, std::move(destroy) });
+	}
+	reclaim();
+}
+
+/**
+ * Destroy every retired object no reader can still see, without waiting
+ */
+void EpochDomain::reclaim() {
+	std::vector<Retired> ready;
+	{
+		std::lock_guard<std::mutex> lock { m_retired_mutex };
+		std::uint64_t oldest { oldestPinned() };
+		auto still_visible = [&](const Retired &retired) {
+			return retired.epoch >= oldest;
+		};
+		auto split { std::stable_partition(m_retired.begin(), m_retired.end(), still_visible) };
+		ready.assign(std::make_move_iterator(split), std::make_move_iterator(m_retired.end()));
+		m_retired.erase(split, m_retired.end());
+	}
+	// destroy outside the lock, other writers may retire meanwhile
+	for (Retired &retired : ready) {
+		retired.destroy();
+	}
+}
+
+/**
+ * Wait until every reader pinned before the call has unpinned, then
+ * reclaim. Must not be called while the calling thread holds a pin.
+ */
+void EpochDomain::synchronize() {
+	std::uint64_t epoch { m_epoch.fetch_add(1, std::memory_order_seq_cst) };
+	while (oldestPinned() <= epoch) {
+		std::this_thread::yield();
+	}
+	reclaim();
+}
+
+/**
+ * @return Retired objects not yet destroyed
+ */
+std::size_t EpochDomain::pending() const {
+	std::lock_guard<std::mutex> lock { m_retired_mutex };
+	return m_retired.size();
+}
@@ -0,0 +1,79 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+/*
+ * Epoch based reclamation for read mostly data
+ *
+ * Readers pin the domain for the duration of a read: one store of the
+ * current epoch into the calling thread's own slot, no locks and no
+ * shared writes. Writers publish a new version with an atomic pointer
+ * store and retire the old one; a retired object is deleted only once
+ * every reader that could still see it has unpinned. This is the RCU
+ * pattern: reads never wait, writers pay for reclamation.
+ *
+ * Each thread gets one slot per domain, by a process wide thread index,
+ * so at most MAX_THREADS threads may read at once.
+ */
+class EpochDomain {
+	public:
+		static constexpr std::size_t MAX_THREADS { 512 };
+
+		/*
+		 * RAII pin, readers hold one while they use published pointers
+		 */
+		class Guard {
+			private:
+				EpochDomain *m_domain;
+				std::size_t m_slot;
+
+			public:
+				explicit Guard(EpochDomain &t_domain);
+				Guard(const Guard &) = delete;
+				Guard &operator=(const Guard &) = delete;
+				~Guard();
+		};
+
+	private:
+		static constexpr std::uint64_t IDLE { UINT64_MAX };
+		// one cache line per thread so pinning never contends
+		struct alignas(64) Slot {
+			std::atomic<std::uint64_t> epoch { IDLE };
+			std::uint32_t depth { }; // nested pins, only touched by the owning thread
+		};
+		struct Retired {
+			std::uint64_t epoch; // deletable once no reader is pinned at or before this
+			std::function<void()> destroy;
+		};
+		std::atomic<std::uint64_t> m_epoch { 1 };
+		std::unique_ptr<Slot[]> m_slots { new Slot[MAX_THREADS] };
+		mutable std::mutex m_retired_mutex;
+		std::vector<Retired> m_retired;
+		std::uint64_t oldestPinned() const;
+
+	public:
+		EpochDomain() = default;
+		EpochDomain(const EpochDomain &) = delete;
+		EpochDomain &operator=(const EpochDomain &) = delete;
+		~EpochDomain();
+		Guard pin();
+		void retire(std::function<void()> destroy);
+		void reclaim();
+		void synchronize();
+		std::size_t pending() const;
+
+		/*
+		 * Retire an object allocated with new
+		 */
+		template <typename T>
+		void retire(const T *object) {
+			if (object != nullptr) {
+				retire([object]() { delete object; });
+			}
+		}
+};
@@ -0,0 +1,165 @@
+#pragma once
+#include <cstdint>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "Course.hpp"
+#include "PerfectHash.hpp"
+
+/*
+ * Read only table of courses for a catalog that no longer changes
+ *
+ * Courses sit at the position their number's minimal perfect hash gives
+ * them (see PerfectHash.hpp), so there are no empty slots and no probe
+ * sequences: a lookup is one hash, one pilot read and one key compare.
+ * Build one from any table with Freeze(), or from a snapshot, which
+ * stores the perfect hash, with ToFrozenTable() (see Snapshot.hpp).
+ *
+ * @tparam Value The stored course type, keyed by its number member
+ */
+template <typename Value = Course>
+class FrozenTable {
+	private:
+		using Key = std::remove_cvref_t<decltype(Value::number)>;
+		PerfectHash m_hash;
+		// course numbers at their hash positions, kept apart from the
+		// payloads so a lookup only reads a small key
+		std::vector<Key> m_keys;
+		std::vector<Value> m_courses; // parallel to m_keys
+
+	public:
+		using const_iterator = typename std::vector<Value>::const_iterator;
+		FrozenTable() = default;
+		FrozenTable(PerfectHash t_hash, std::vector<Value> t_courses);
+		const Value *find(std::string_view course_number) const;
+		Value search(std::string_view course_number) const;
+		bool contains(std::string_view course_number) const;
+		template <typename F>
+		void for_each(F &&fn) const;
+		const_iterator begin() const;
+		const_iterator end() const;
+		std::size_t size() const;
+		const PerfectHash &perfect_hash() const;
+};
+
+/**
+ * @param t_hash A perfect hash over the courses' numbers
+ * @param t_courses The courses, each at its number's position
+ */
+template <typename Value>
+FrozenTable<Value>::FrozenTable(PerfectHash t_hash, std::vector<Value> t_courses) : m_hash { std::move(t_hash) }, m_courses { std::move(t_courses) } {
+	m_keys.reserve(m_courses.size());
+	for (const Value &course : m_courses) {
+		m_keys.push_back(course.number);
+	}
+}
+
+/**
+ * Find a course without copying it
+ *
+ * @param course_number The course number to search for
+ * @return The course, or nullptr if not found
+ */
+template <typename Value>
+const Value *FrozenTable<Value>::find(std::string_view course_number) const {
+	if (m_courses.empty()) {
+		return nullptr;
+	}
+	std::uint32_t position { m_hash(course_number) };
+	return std::string_view { m_keys[position] } == course_number ? &m_courses[position] : nullptr;
+}
+
+/**
+ * @param course_number The course number to search for
+ * @return A copy of the course, or an empty course if not found
+ */
+template <typename Value>
+Value FrozenTable<Value>::search(std::string_view course_number) const {
+	const Value *course { find(course_number) };
+	return course != nullptr ? *course : Value { };
+}
+
+/**
+ * @param course_number The course number to search for
+ */
+template <typename Value>
+bool FrozenTable<Value>::contains(std::string_view course_number) const {
+	return find(course_number) != nullptr;
+}
+
+/**
+ * Call fn(const Value &) for every course, in no particular order
+ *
+ * @param fn The function to call
+ */
+template <typename Value>
+template <typename F>
+void FrozenTable<Value>::for_each(F &&fn) const {
+	for (const Value &course : m_courses) {
+		fn(course);
+	}
+}
+
+/**
+ * @return Iterator to the first course, in no particular order
+ */
+template <typename Value>
+typename FrozenTable<Value>::const_iterator FrozenTable<Value>::begin() const {
+	return m_courses.begin();
+}
+
+/**
+ * @return Iterator past the last course
+ */
+template <typename Value>
+typename FrozenTable<Value>::const_iterator FrozenTable<Value>::end() const {
+	return m_courses.end();
+}
+
+/**
+ * @return The number of courses
+ */
+template <typename Value>
+std::size_t FrozenTable<Value>::size() const {
+	return m_courses.size();
+}
+
+/**
+ * @return The hash placing the courses
+ */
+template <typename Value>
+const PerfectHash &FrozenTable<Value>::perfect_hash() const {
+	return m_hash;
+}
+
+/*
+ * Copy a table into a FrozenTable
+ *
+ * Works with any table providing find and for_each(fn(const Value &))
+ * over values with unique number members, such as HashTable.
+ *
+ * @param table The table to freeze
+ * @param frozen Receives the frozen copy
+ * @return false if no perfect hash was found, leaving frozen alone
+ */
+template <typename Table>
+bool Freeze(const Table &table, FrozenTable<std::remove_cvref_t<decltype(*table.find(std::string_view { }))>> &frozen) {
+	using Value = std::remove_cvref_t<decltype(*table.find(std::string_view { }))>;
+	std::vector<const Value *> courses;
+	std::vector<std::string_view> keys;
+	table.for_each([&](const Value &course) {
+		courses.push_back(&course);
+		keys.push_back(course.number);
+	});
+	PerfectHash hash;
+	if (!hash.build(keys)) {
+		return false;
+	}
+	std::vector<Value> placed(courses.size());
+	for (const Value *course : courses) {
+		placed[hash(course->number)] = *course;
+	}
+	frozen = FrozenTable<Value> { std::move(hash), std::move(placed) };
+	return true;
+}
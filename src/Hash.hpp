@@ -0,0 +1,93 @@
+#pragma once
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+
+/*
+ * Hash policies for HashTable
+ *
+ * A policy is a default constructible callable taking a std::string_view
+ * and returning a 64 bit hash. All policies here are integer only and
+ * deterministic across runs, so table layouts are reproducible.
+ */
+
+namespace hash_detail {
+	// read 8 (or fewer) bytes as a little endian word without alignment requirements
+	inline std::uint64_t read64(const char *p) {
+		std::uint64_t v;
+		std::memcpy(&v, p, sizeof(v));
+		return v;
+	}
+	inline std::uint64_t readTail(const char *p, std::size_t len) {
+		std::uint64_t v { };
+		std::memcpy(&v, p, len);
+		return v;
+	}
+	// 64x64 -> 128 bit multiply, folded back to 64 bits
+	constexpr std::uint64_t mum(std::uint64_t a, std::uint64_t b) {
+#if defined(__SIZEOF_INT128__)
+		__uint128_t r { static_cast<__uint128_t>(a) * b };
+		return static_cast<std::uint64_t>(r) ^ static_cast<std::uint64_t>(r >> 64);
+#else
+		std::uint64_t ha { a >> 32 }, la { a & 0xffffffff }, hb { b >> 32 }, lb { b & 0xffffffff };
+		std::uint64_t hh { ha * hb }, hl { ha * lb }, lh { la * hb }, ll { la * lb };
+		std::uint64_t mid { (ll >> 32) + (hl & 0xffffffff) + (lh & 0xffffffff) };
+		std::uint64_t lo { (ll & 0xffffffff) | (mid << 32) };
+		std::uint64_t hi { hh + (hl >> 32) + (lh >> 32) + (mid >> 32) };
+		return lo ^ hi;
+#endif
+	}
+}
+
+/*
+ * wyhash style hash: consumes the key 8 bytes at a time and mixes
+ * each word with a 128 bit multiply. Default policy for HashTable.
+ */
+struct WyHash {
+	std::uint64_t operator()(std::string_view key) const {
+		constexpr std::uint64_t P0 { 0xa0761d6478bd642full }, P1 { 0xe7037ed1a0b428dbull };
+		const char *p { key.data() };
+		std::size_t len { key.size() };
+		std::uint64_t seed { P0 ^ len };
+		for (; len > 8; len -= 8, p += 8) {
+			seed = hash_detail::mum(hash_detail::read64(p) ^ P1, seed ^ P0);
+		}
+		return hash_detail::mum(hash_detail::readTail(p, len) ^ P1, seed ^ key.size());
+	}
+};
+
+/*
+ * FNV-1a applied to 8 byte words instead of single bytes
+ */
+struct Fnv1aHash {
+	std::uint64_t operator()(std::string_view key) const {
+		constexpr std::uint64_t OFFSET { 0xcbf29ce484222325ull }, PRIME { 0x100000001b3ull };
+		const char *p { key.data() };
+		std::size_t len { key.size() };
+		std::uint64_t h { OFFSET };
+		for (; len >= 8; len -= 8, p += 8) {
+			h = (h ^ hash_detail::read64(p)) * PRIME;
+		}
+		if (len > 0) {
+			h = (h ^ hash_detail::readTail(p, len)) * PRIME;
+		}
+		// final avalanche so the low bits used for slot selection depend on every byte
+		h ^= h >> 32;
+		h *= PRIME;
+		return h ^ (h >> 29);
+	}
+};
+
+/*
+ * Polynomial base 31 hash, an integer only version of the original
+ * pow() based hash. Kept for comparison in benchmarks.
+ */
+struct Polynomial31Hash {
+	std::uint64_t operator()(std::string_view key) const {
+		std::uint64_t sum { };
+		for (char c : key) {
+			sum = sum * 31 + static_cast<unsigned char>(c);
+		}
+		return sum;
+	}
+};
@@ -0,0 +1,1010 @@
+#pragma once
+#include <string>
+#include <string_view>
+#include <fstream>
+#include <vector>
+#include <climits>
+#include <cstdint>
+#include <algorithm>
+#include <type_traits>
+#include <iterator>
+#include <span>
+#include <array>
+#include "Course.hpp"
+#include "CourseKey.hpp"
+#include "Hash.hpp"
+#include "Sort.hpp"
+#include "Stats.hpp"
+
+/*
+ * Shape of a HashTable at one moment, see HashTable::stats()
+ */
+struct HashTableStats {
+	std::size_t size { };
+	std::size_t slots { }; // current slot array
+	std::size_t old_slots { }; // slot array still being migrated, 0 if none
+	float load_factor { };
+	// resident courses by how far their slot is from their home slot,
+	// the probes a successful lookup makes; the last bucket is 16 or more
+	std::array<std::size_t, PROBE_BUCKETS> probe_lengths { };
+	unsigned int max_probe { };
+	double mean_probe { };
+};
+
+/*
+ * Open addressed (Robin Hood) table of courses keyed by course number
+ *
+ * The table grows by doubling once max_load_factor() is exceeded. Growth
+ * is incremental: the old slot array is kept alongside the new one and
+ * migrated a few slots per insert/remove, so no single insert pays for
+ * re-placing the whole table. Lookups check both arrays until the
+ * migration finishes. Removal is a backward shift, leaving no tombstones
+ * in the live array, and once removals take the load below a quarter of
+ * max_load_factor() the table compacts to fit, so memory follows the
+ * live size under sustained insert/remove churn.
+ *
+ * A secondary index keeps payload indices sorted by course number for
+ * ordered listing and range queries. It is built on the first ordered
+ * access (a bulk load never pays for it) and from then on updated in
+ * place by insert and remove, with a binary search and a shift of 4 byte
+ * indices: O(n) per new or removed number, cheap per change but not for
+ * many. After ORDER_SHIFT_LIMIT shifts since it was last built the index
+ * is left stale instead, so a batch of changes costs at most that many
+ * shifts and one rebuild. Every change bumps generation(); the index
+ * records the generation it reflects, so a stale index is rebuilt on
+ * next use.
+ *
+ * @tparam Hash Hash policy, see Hash.hpp
+ * @tparam Value The stored course type, keyed by its number member. Keys
+ * are stored as the type of that member, so a Value whose number is a
+ * std::string_view (see ArenaCourse) keeps keys out of the table too, and
+ * one whose number is a CourseKey (see KeyedCourse) is hashed and
+ * compared as two integers, without reading key bytes out of line or
+ * calling Hash. Lookups still take text; it is packed into a CourseKey
+ * once per call, and text that does not fit one is simply not found.
+ * Courses whose number does not fit are not inserted at all, since every
+ * invalid key is equal to every other.
+ */
+template <typename Hash = WyHash, typename Value = Course>
+class HashTable {
+	private:
+		using Key = std::remove_cvref_t<decltype(Value::number)>;
+		// what a lookup compares stored keys against
+		using Probe = std::conditional_t<std::is_same_v<Key, CourseKey>, CourseKey, std::string_view>;
+		// Open-addressed slot. The course itself lives out of line in
+		// m_courses, so probing only touches these 8 byte slots.
+		struct Slot {
+			unsigned int hash { }; // full hash, used to recover probe distance
+			unsigned int index { EMPTY }; // index into m_keys and m_courses
+		};
+		static constexpr unsigned int EMPTY { UINT_MAX };
+		// removed from (or migrated out of) the old slot array during a rehash;
+		// keeps its hash so probe distances past it stay valid
+		static constexpr unsigned int TOMBSTONE { UINT_MAX - 1 };
+		// old slots migrated per insert/remove while rehashing
+		static constexpr unsigned int MIGRATE_STEP { 8 };
+		// keys search_batch keeps in flight, enough to cover a miss per key
+		static constexpr std::size_t BATCH_STEP { 16 };
+		// in place ordered index updates before it is left to a rebuild,
+		// about where the shifts of a large index cost as much as a sort
+		static constexpr unsigned int ORDER_SHIFT_LIMIT { 1024 };
+	std::vector<Slot> m_slots;
+	std::vector<Slot> m_old_slots; // non-empty while a rehash is in progress
+	unsigned int m_migrated { }; // old slots below this index have been migrated
+	std::vector<Key> m_keys; // course numbers, stored contiguously
+	std::vector<Value> m_courses; // course payloads, parallel to m_keys
+	float m_max_load { 0.875f };
+	[[no_unique_address]] Hash m_hasher;
+	std::uint64_t m_generation { }; // bumped by every insert and remove
+	// payload indices ordered by course number, lazily built and then kept current
+	mutable std::vector<unsigned int> m_order;
+	mutable std::uint64_t m_order_generation { UINT64_MAX }; // generation m_order reflects
+	mutable unsigned int m_order_shifts { }; // in place updates of m_order since it was built
+	unsigned int hash(const Probe &course_number) const;
+	static unsigned int distance(const std::vector<Slot> &slots, const unsigned int &pos, const unsigned int &hash);
+	static unsigned int findSlot(const std::vector<Slot> &slots, const std::vector<Key> &keys, const Probe &course_number, const unsigned int &hash);
+	unsigned int capacityFor(const std::size_t &count) const;
+	unsigned int *locate(const Probe &course_number, const unsigned int &hash);
+	const unsigned int *locate(const Probe &course_number, const unsigned int &hash) const;
+	void place(Slot entry);
+	void migrate(unsigned int count);
+	void grow();
+	void rehash(const unsigned int &capacity);
+	bool orderCurrent() const;
+	const std::vector<unsigned int> &order() const;
+	std::vector<unsigned int>::iterator orderPosition(std::string_view course_number) const;
+
+	public:
+		HashTable();
+		HashTable(const unsigned int &t_size);
+		void loadFromCSV(const std::string &file_path);
+		void insert(const Value &course);
+		void insert(Value &&course);
+		void remove(std::string_view course_number);
+		Value search(std::string_view course_number) const;
+		const Value *find(std::string_view course_number) const;
+		const Value *find(const CourseKey &course_number) const requires std::is_same_v<Key, CourseKey>;
+		void search_batch(std::span<const std::string_view> course_numbers, std::span<const Value *> results) const;
+		std::vector<const Value *> search_batch(std::span<const std::string_view> course_numbers) const;
+		bool contains(std::string_view course_number) const;
+		bool contains(const CourseKey &course_number) const requires std::is_same_v<Key, CourseKey>;
+		std::vector<Value> toVector() const;
+		// courses are stored densely, iteration is a walk over one array
+		using const_iterator = typename std::vector<Value>::const_iterator;
+		const_iterator begin() const;
+		const_iterator end() const;
+		template <typename F>
+		void for_each(F &&fn) const;
+		// lazy view of the courses numbered in a half open interval, in order;
+		// walks the ordered index directly and is invalidated by insert and remove
+		class OrderedRange {
+			private:
+				using Position = std::vector<unsigned int>::const_iterator;
+				const HashTable *m_table;
+				Position m_first, m_last;
+
+			public:
+				class iterator {
+					private:
+						const HashTable *m_table { nullptr };
+						Position m_pos;
+
+					public:
+						using iterator_category = std::forward_iterator_tag;
+						using value_type = Value;
+						using difference_type = std::ptrdiff_t;
+						using pointer = const Value *;
+						using reference = const Value &;
+						iterator() = default;
+						iterator(const HashTable *t_table, Position t_pos) : m_table(t_table), m_pos(t_pos) { }
+						reference operator*() const { return m_table->m_courses[*m_pos]; }
+						pointer operator->() const { return &**this; }
+						iterator &operator++() { ++m_pos; return *this; }
+						iterator operator++(int) { iterator old { *this }; ++m_pos; return old; }
+						bool operator==(const iterator &other) const { return m_pos == other.m_pos; }
+				};
+				OrderedRange(const HashTable *t_table, Position t_first, Position t_last) : m_table(t_table), m_first(t_first), m_last(t_last) { }
+				iterator begin() const { return { m_table, m_first }; }
+				iterator end() const { return { m_table, m_last }; }
+				std::size_t size() const { return m_last - m_first; }
+				bool empty() const { return m_first == m_last; }
+		};
+		OrderedRange ordered() const;
+		OrderedRange range(std::string_view first, std::string_view last) const;
+		OrderedRange rangeFrom(std::string_view first) const;
+		OrderedRange prefix(std::string_view course_prefix) const;
+		template <typename F>
+		void for_each_ordered(F &&fn) const;
+		template <typename F>
+		void for_each_range(std::string_view first, std::string_view last, F &&fn) const;
+		std::size_t count_range(std::string_view first, std::string_view last) const;
+		std::uint64_t generation() const;
+		std::size_t size() const;
+		std::size_t bucket_count() const;
+		float load_factor() const;
+		float max_load_factor() const;
+		void max_load_factor(const float &t_max_load);
+		void reserve(const std::size_t &count);
+		void shrink_to_fit();
+		HashTableStats stats() const;
+};
+
+/**
+ * Default constructor
+ */
+template <typename Hash, typename Value>
+HashTable<Hash, Value>::HashTable() : HashTable(0) { }
+
+/**
+ * Constructor for specifying size of the table
+ * Use to avoid growing while loading a known number of courses.
+ * The slot count is rounded up to a power of two
+ * that holds t_size courses under max_load_factor().
+ */
+template <typename Hash, typename Value>
+HashTable<Hash, Value>::HashTable(const unsigned int &t_size) {
+	m_slots.resize(capacityFor(t_size));
+	m_keys.reserve(t_size);
+	m_courses.reserve(t_size);
+}
+
+/*
+ * Load Courses from Comma Separated List
+ *
+ * @param const std::string path to file
+*/
+template <typename Hash, typename Value>
+void HashTable<Hash, Value>::loadFromCSV(const std::string &file_path) {
+	CSC300_TIME(Load);
+	// set up vars for reading file
+	std::ifstream csv { file_path };
+	std::string row;
+	const char ROW_DEL { '\n' }, COL_DEL { ',' };
+	// iter by row
+	while (getline(csv, row, ROW_DEL)) {
+		std::string field;
+		int field_count { };
+		std::size_t start { };
+		std::size_t end { };
+		std::string number, title;
+		std::vector<std::string> prerequisites;
+		// iter by column
+		while ((end = row.find(COL_DEL, start)) != std::string::npos) {
+			field = row.substr(start, end - start);
+			// skip empty fields
+			if (end - start == 0) {
+				start = end + 1;
+				continue;
+			}
+			// determine field type
+			switch(field_count) {
+			case 0: // course number
+				number = field;
+				break;
+			case 1: // course title
+				title = field;
+				break;
+			default: // course prerequisite
+				prerequisites.push_back(field);
+				break;
+			}
+			++field_count;
+			start = end + 1;
+		}
+		// if there's still more data but no more commas:
+		// add it to prerequisites
+		// start < length - 1, without underflowing on an empty row
+		if (start + 1 < row.length()) {
+			prerequisites.push_back(row.substr(start, row.length() - start - 1).data());
+		}
+		// a blank line has no course to insert
+		if (number.empty()) {
+			continue;
+		}
+		// insert data into data struct
+		insert({number, title, prerequisites});
+	}
+	csv.close();
+}
+
+/**
+ * Calculate the hash value of a given key.
+ * The 64 bit policy hash is folded to 32 bits; it is not
+ * reduced to the table size, slots are chosen by masking off the low bits.
+ *
+ * @param key The key to hash
+ * @return The calculated hash
+ */
+template <typename Hash, typename Value>
+unsigned int HashTable<Hash, Value>::hash(const Probe &key) const {
+	std::uint64_t h;
+	if constexpr (std::is_same_v<Probe, CourseKey>) {
+		h = key.hash();
+	} else {
+		h = m_hasher(key);
+	}
+	return static_cast<unsigned int>(h ^ (h >> 32));
+}
+
+/**
+ * Distance of a slot from the home slot of a hash
+ *
+ * @param slots The slot array pos belongs to
+ * @param pos The slot index
+ * @param hash The hash stored in the slot
+ * @return The number of probes it took to place the hash at pos
+ */
+template <typename Hash, typename Value>
+unsigned int HashTable<Hash, Value>::distance(const std::vector<Slot> &slots, const unsigned int &pos, const unsigned int &hash) {
+	unsigned int mask { static_cast<unsigned int>(slots.size() - 1) };
+	return (pos - (hash & mask)) & mask;
+}
+
+/**
+ * Find the slot holding a course number
+ *
+ * @param slots The slot array to probe
+ * @param keys The course numbers slot indices refer to
+ * @param course_number The course number to search for
+ * @param hash The hash of course_number
+ * @return The slot index, or EMPTY if not found
+ */
+template <typename Hash, typename Value>
+unsigned int HashTable<Hash, Value>::findSlot(const std::vector<Slot> &slots, const std::vector<Key> &keys, const Probe &course_number, const unsigned int &hash) {
+	if constexpr (std::is_same_v<Probe, CourseKey>) {
+		// invalid keys all compare equal, so none may match a stored one
+		if (!course_number.valid()) {
+			return EMPTY;
+		}
+	}
+	unsigned int mask { static_cast<unsigned int>(slots.size() - 1) };
+	unsigned int pos { hash & mask };
+	for (unsigned int dist { }; ; ++dist) {
+		const Slot &slot { slots[pos] };
+		// robin hood invariant: the key would have displaced any entry closer to home
+		if (slot.index == EMPTY || distance(slots, pos, slot.hash) < dist) {
+			CSC300_PROBES(dist);
+			return EMPTY;
+		}
+		if (slot.index != TOMBSTONE && slot.hash == hash && keys[slot.index] == course_number) {
+			CSC300_PROBES(dist);
+			return pos;
+		}
+		pos = (pos + 1) & mask; // move forward in probe sequence
+	}
+}
+
+/**
+ * Smallest power of two slot count holding count courses under max_load_factor()
+ *
+ * @param count The number of courses
+ */
+template <typename Hash, typename Value>
+unsigned int HashTable<Hash, Value>::capacityFor(const std::size_t &count) const {
+	unsigned int capacity { 8 };
+	while (capacity * m_max_load < count) {
+		capacity <<= 1;
+	}
+	return capacity;
+}
+
+/**
+ * Find the payload index stored for a course number,
+ * checking the old slot array while a rehash is in progress
+ *
+ * @param course_number The course number to search for
+ * @param hash The hash of course_number
+ * @return Pointer to the slot's payload index, or nullptr if not found
+ */
+template <typename Hash, typename Value>
+unsigned int *HashTable<Hash, Value>::locate(const Probe &course_number, const unsigned int &hash) {
+	unsigned int pos { findSlot(m_slots, m_keys, course_number, hash) };
+	if (pos != EMPTY) {
+		return &m_slots[pos].index;
+	}
+	if (!m_old_slots.empty() && (pos = findSlot(m_old_slots, m_keys, course_number, hash)) != EMPTY) {
+		return &m_old_slots[pos].index;
+	}
+	return nullptr;
+}
+
+template <typename Hash, typename Value>
+const unsigned int *HashTable<Hash, Value>::locate(const Probe &course_number, const unsigned int &hash) const {
+	// only lookups come through the const overload
+	CSC300_COUNT(Lookups);
+	const unsigned int *index { const_cast<HashTable *>(this)->locate(course_number, hash) };
+	if (index == nullptr) {
+		CSC300_COUNT(Misses);
+	}
+	return index;
+}
+
+/**
+ * Place an entry in the first free slot of its probe sequence,
+ * displacing entries that sit closer to their home slot.
+ *
+ * @param entry The slot to place
+ */
+template <typename Hash, typename Value>
+void HashTable<Hash, Value>::place(Slot entry) {
+	unsigned int mask { static_cast<unsigned int>(m_slots.size() - 1) };
+	unsigned int pos { entry.hash & mask };
+	unsigned int dist { };
+	while (m_slots[pos].index != EMPTY) {
+		unsigned int cur_dist { distance(m_slots, pos, m_slots[pos].hash) };
+		// take from the rich: swap with an entry that is closer to home
+		if (cur_dist < dist) {
+			std::swap(entry, m_slots[pos]);
+			dist = cur_dist;
+		}
+		pos = (pos + 1) & mask;
+		++dist;
+	}
+	m_slots[pos] = entry;
+}
+
+/**
+ * Move up to count old slots into the current slot array.
+ * Migrated slots become tombstones so probes through them still work;
+ * the old array is released once every slot has been visited.
+ *
+ * @param count The number of old slots to visit
+ */
+template <typename Hash, typename Value>
+void HashTable<Hash, Value>::migrate(unsigned int count) {
+	if (m_old_slots.empty()) {
+		return;
+	}
+	while (count-- > 0 && m_migrated < m_old_slots.size()) {
+		Slot &slot { m_old_slots[m_migrated++] };
+		if (slot.index < TOMBSTONE) {
+			place(slot);
+			slot.index = TOMBSTONE;
+		}
+	}
+	if (m_migrated == m_old_slots.size()) {
+		m_old_slots.clear();
+		m_old_slots.shrink_to_fit();
+		m_migrated = 0;
+	}
+}
+
+/**
+ * Start an incremental rehash into twice as many slots
+ */
+template <typename Hash, typename Value>
+void HashTable<Hash, Value>::grow() {
+	CSC300_COUNT(Grows);
+	// a rehash still in flight must land before the next one starts
+	migrate(UINT_MAX);
+	m_old_slots = std::move(m_slots);
+	m_slots.assign(m_old_slots.size() * 2, Slot {});
+	m_migrated = 0;
+}
+
+/**
+ * Rehash every entry into capacity slots immediately
+ *
+ * @param capacity The new slot count, a power of two
+ */
+template <typename Hash, typename Value>
+void HashTable<Hash, Value>::rehash(const unsigned int &capacity) {
+	migrate(UINT_MAX);
+	std::vector<Slot> old_slots { std::move(m_slots) };
+	m_slots.assign(capacity, Slot {});
+	for (const Slot &slot : old_slots) {
+		if (slot.index != EMPTY) {
+			place(slot);
+		}
+	}
+}
+
+/**
+ * Insert a course, replacing any course with the same number
+ *
+ * @param Course The course to insert
+ */
+template <typename Hash, typename Value>
+void HashTable<Hash, Value>::insert(const Value &course) {
+	insert(Value { course });
+}
+
+/**
+ * Insert a course, replacing any course with the same number
+ *
+ * @param Course The course to move into the table
+ */
+template <typename Hash, typename Value>
+void HashTable<Hash, Value>::insert(Value &&course) {
+	if constexpr (std::is_same_v<Key, CourseKey>) {
+		// see the class comment, an invalid key would replace any other
+		if (!course.number.valid()) {
+			return;
+		}
+	}
+	CSC300_COUNT(Inserts);
+	unsigned int key { hash(course.number) };
+	// if course exists, overwrite its payload
+	bool order_current { orderCurrent() };
+	++m_generation;
+	if (unsigned int *index { locate(course.number, key) }) {
+		m_courses[*index] = std::move(course);
+		// same number, same position in the ordered index
+		if (order_current) {
+			m_order_generation = m_generation;
+		}
+		return;
+	}
+	if (order_current && m_order_shifts < ORDER_SHIFT_LIMIT) {
+		++m_order_shifts;
+		m_order.insert(std::upper_bound(m_order.begin(), m_order.end(), std::string_view { course.number }, [this](std::string_view number, unsigned int i) {
+			return number < std::string_view { m_keys[i] };
+		}), static_cast<unsigned int>(m_keys.size()));
+		m_order_generation = m_generation;
+	}
+	migrate(MIGRATE_STEP);
+	// old entries still waiting to migrate count towards the new array's load
+	if (m_keys.size() + 1 > m_slots.size() * m_max_load) {
+		grow();
+		migrate(MIGRATE_STEP);
+	}
+	m_keys.push_back(course.number);
+	m_courses.push_back(std::move(course));
+	place({ key, static_cast<unsigned int>(m_keys.size() - 1) });
+}
+
+/**
+ * Get Vector representation of table
+ *
+ * @return a vector of all courses within table
+ */
+template <typename Hash, typename Value>
+std::vector<Value> HashTable<Hash, Value>::toVector() const {
+	// payloads are already dense
+	return m_courses;
+}
+
+/**
+ * Remove a course
+ *
+ * @param course_number The course number to search for
+ */
+template <typename Hash, typename Value>
+void HashTable<Hash, Value>::remove(std::string_view course_number) {
+	CSC300_COUNT(Removes);
+	Probe probe { course_number };
+	unsigned int key { hash(probe) };
+	unsigned int index { };
+	unsigned int pos { findSlot(m_slots, m_keys, probe, key) };
+	if (pos != EMPTY) {
+		index = m_slots[pos].index;
+		// backward shift: pull following entries one slot closer to home
+		// until an empty slot or an entry already at home is reached
+		unsigned int mask { static_cast<unsigned int>(m_slots.size() - 1) };
+		unsigned int next { (pos + 1) & mask };
+		while (m_slots[next].index != EMPTY && distance(m_slots, next, m_slots[next].hash) != 0) {
+			m_slots[pos] = m_slots[next];
+			pos = next;
+			next = (next + 1) & mask;
+		}
+		m_slots[pos] = Slot {};
+	} else if (!m_old_slots.empty() && (pos = findSlot(m_old_slots, m_keys, probe, key)) != EMPTY) {
+		// the old array is never shifted, it only has to survive until migrated
+		index = m_old_slots[pos].index;
+		m_old_slots[pos].index = TOMBSTONE;
+	} else {
+		return;
+	}
+	bool order_current { orderCurrent() };
+	++m_generation;
+	unsigned int last { static_cast<unsigned int>(m_keys.size() - 1) };
+	if (order_current && m_order_shifts < ORDER_SHIFT_LIMIT) {
+		++m_order_shifts;
+		m_order.erase(orderPosition(course_number));
+		if (index != last) {
+			*orderPosition(m_keys[last]) = index;
+		}
+		m_order_generation = m_generation;
+	}
+	// keep payloads dense by moving the last course into the hole
+	if (index != last) {
+		*locate(m_keys[last], hash(m_keys[last])) = index;
+		m_keys[index] = std::move(m_keys[last]);
+		m_courses[index] = std::move(m_courses[last]);
+	}
+	m_keys.pop_back();
+	m_courses.pop_back();
+	migrate(MIGRATE_STEP);
+	// compact at a quarter of the growth threshold: the table is then half
+	// full, so shrinking and growing each take many operations to trigger
+	if (m_old_slots.empty() && m_slots.size() > 8 && m_keys.size() < m_slots.size() * m_max_load / 4) {
+		shrink_to_fit();
+	}
+}
+
+/**
+ * Search for the specified course number
+ *
+ * @param course_number The course number to search for
+ * @return A copy of the course, or an empty course if not found
+ */
+template <typename Hash, typename Value>
+Value HashTable<Hash, Value>::search(std::string_view course_number) const {
+	if (const Value *course { find(course_number) }) {
+		return *course;
+	}
+	// couldn't find course, return an empty one
+	return Value {};
+}
+
+/**
+ * Find the specified course number without copying the course
+ *
+ * @param course_number The course number to search for
+ * @return The course, or nullptr if not found. Invalidated by insert and remove.
+ */
+template <typename Hash, typename Value>
+const Value *HashTable<Hash, Value>::find(std::string_view course_number) const {
+	Probe probe { course_number };
+	if (const unsigned int *index { locate(probe, hash(probe)) }) {
+		return &m_courses[*index];
+	}
+	return nullptr;
+}
+
+/**
+ * Find an already packed course number, nothing is parsed or read out of line
+ *
+ * @param course_number The course number to search for
+ * @return The course, or nullptr if not found. Invalidated by insert and remove.
+ */
+template <typename Hash, typename Value>
+const Value *HashTable<Hash, Value>::find(const CourseKey &course_number) const requires std::is_same_v<Key, CourseKey> {
+	if (const unsigned int *index { locate(course_number, hash(course_number)) }) {
+		return &m_courses[*index];
+	}
+	return nullptr;
+}
+
+namespace hash_detail {
+	// hint that p is about to be read
+	inline void prefetch(const void *p) {
+#if defined(__GNUC__) || defined(__clang__)
+		__builtin_prefetch(p);
+#else
+		(void)p;
+#endif
+	}
+}
+
+/**
+ * Find many course numbers at once. Keys are taken BATCH_STEP at a time:
+ * all of them are hashed and their home slots prefetched, then the first
+ * slot with a matching hash is looked up and its key and course
+ * prefetched, and only then is each key resolved. The misses of a step
+ * overlap instead of being paid one after another.
+ *
+ * @param course_numbers The course numbers to search for
+ * @param results Receives each course, or nullptr if not found, at the
+ *        position of its number; at least course_numbers.size() long.
+ *        Invalidated by insert and remove.
+ */
+template <typename Hash, typename Value>
+void HashTable<Hash, Value>::search_batch(std::span<const std::string_view> course_numbers, std::span<const Value *> results) const {
+	if (m_slots.empty()) {
+		std::fill_n(results.begin(), course_numbers.size(), nullptr);
+		return;
+	}
+	const unsigned int mask { static_cast<unsigned int>(m_slots.size() - 1) };
+	const unsigned int old_mask { static_cast<unsigned int>(m_old_slots.size() - 1) };
+	unsigned int hashes[BATCH_STEP];
+	Probe probes[BATCH_STEP];
+	for (std::size_t first = 0; first < course_numbers.size(); first += BATCH_STEP) {
+		std::size_t count { std::min(BATCH_STEP, course_numbers.size() - first) };
+		for (std::size_t i = 0; i < count; ++i) {
+			probes[i] = Probe { course_numbers[first + i] };
+			hashes[i] = hash(probes[i]);
+			hash_detail::prefetch(&m_slots[hashes[i] & mask]);
+			if (!m_old_slots.empty()) {
+				hash_detail::prefetch(&m_old_slots[hashes[i] & old_mask]);
+			}
+		}
+		for (std::size_t i = 0; i < count; ++i) {
+			// the likely match, usually the home slot itself
+			for (unsigned int pos { hashes[i] & mask }, dist { }; m_slots[pos].index != EMPTY && distance(m_slots, pos, m_slots[pos].hash) >= dist; pos = (pos + 1) & mask, ++dist) {
+				if (m_slots[pos].hash == hashes[i] && m_slots[pos].index != TOMBSTONE) {
+					hash_detail::prefetch(std::string_view { m_keys[m_slots[pos].index] }.data());
+					hash_detail::prefetch(&m_courses[m_slots[pos].index]);
+					break;
+				}
+			}
+		}
+		for (std::size_t i = 0; i < count; ++i) {
+			const unsigned int *index { locate(probes[i], hashes[i]) };
+			results[first + i] = index ? &m_courses[*index] : nullptr;
+		}
+	}
+}
+
+/**
+ * Find many course numbers at once, see the overload taking a result span
+ *
+ * @param course_numbers The course numbers to search for
+ * @return Each course, or nullptr if not found, in the order of course_numbers
+ */
+template <typename Hash, typename Value>
+std::vector<const Value *> HashTable<Hash, Value>::search_batch(std::span<const std::string_view> course_numbers) const {
+	std::vector<const Value *> results(course_numbers.size());
+	search_batch(course_numbers, results);
+	return results;
+}
+
+/**
+ * @return Iterator to the first course, in no particular order
+ */
+template <typename Hash, typename Value>
+typename HashTable<Hash, Value>::const_iterator HashTable<Hash, Value>::begin() const {
+	return m_courses.begin();
+}
+
+/**
+ * @return Iterator past the last course
+ */
+template <typename Hash, typename Value>
+typename HashTable<Hash, Value>::const_iterator HashTable<Hash, Value>::end() const {
+	return m_courses.end();
+}
+
+/**
+ * Call fn(const Value &) for every course without copying any
+ *
+ * @param fn The function to call
+ */
+template <typename Hash, typename Value>
+template <typename F>
+void HashTable<Hash, Value>::for_each(F &&fn) const {
+	for (const Value &course : m_courses) {
+		fn(course);
+	}
+}
+
+/**
+ * Check whether a course number is in the table without copying it
+ *
+ * @param course_number The course number to search for
+ */
+template <typename Hash, typename Value>
+bool HashTable<Hash, Value>::contains(std::string_view course_number) const {
+	Probe probe { course_number };
+	return locate(probe, hash(probe)) != nullptr;
+}
+
+/**
+ * Check whether an already packed course number is in the table
+ *
+ * @param course_number The course number to search for
+ */
+template <typename Hash, typename Value>
+bool HashTable<Hash, Value>::contains(const CourseKey &course_number) const requires std::is_same_v<Key, CourseKey> {
+	return locate(course_number, hash(course_number)) != nullptr;
+}
+
+/**
+ * @return The number of courses in the table
+ */
+template <typename Hash, typename Value>
+std::size_t HashTable<Hash, Value>::size() const {
+	return m_keys.size();
+}
+
+/**
+ * @return The number of slots in the current slot array
+ */
+template <typename Hash, typename Value>
+std::size_t HashTable<Hash, Value>::bucket_count() const {
+	return m_slots.size();
+}
+
+/**
+ * @return Courses per slot
+ */
+template <typename Hash, typename Value>
+float HashTable<Hash, Value>::load_factor() const {
+	return static_cast<float>(m_keys.size()) / m_slots.size();
+}
+
+/**
+ * @return The load factor that triggers growth
+ */
+template <typename Hash, typename Value>
+float HashTable<Hash, Value>::max_load_factor() const {
+	return m_max_load;
+}
+
+/**
+ * Set the load factor that triggers growth.
+ * Clamped to [0.25, 0.95] since a full robin hood table never terminates a probe.
+ * Grows immediately if the table is already past the new limit.
+ *
+ * @param t_max_load The new maximum load factor
+ */
+template <typename Hash, typename Value>
+void HashTable<Hash, Value>::max_load_factor(const float &t_max_load) {
+	m_max_load = std::clamp(t_max_load, 0.25f, 0.95f);
+	reserve(m_keys.size());
+}
+
+/**
+ * Make room for count courses without any further growth
+ *
+ * @param count The number of courses to make room for
+ */
+template <typename Hash, typename Value>
+void HashTable<Hash, Value>::reserve(const std::size_t &count) {
+	unsigned int capacity { capacityFor(count) };
+	if (capacity > m_slots.size()) {
+		rehash(capacity);
+	}
+	m_keys.reserve(count);
+	m_courses.reserve(count);
+}
+
+/**
+ * Release memory held for courses no longer in the table: the slot
+ * array shrinks to the smallest that holds size() courses and the
+ * payload arrays to their size. remove() calls this once the table is
+ * mostly empty. Invalidates pointers to courses.
+ */
+template <typename Hash, typename Value>
+void HashTable<Hash, Value>::shrink_to_fit() {
+	unsigned int capacity { capacityFor(m_keys.size()) };
+	if (capacity < m_slots.size()) {
+		CSC300_COUNT(Shrinks);
+		rehash(capacity);
+	}
+	m_keys.shrink_to_fit();
+	m_courses.shrink_to_fit();
+	if (m_order.capacity() > m_order.size() * 2) {
+		m_order.shrink_to_fit();
+	}
+}
+
+/**
+ * @return true if the ordered index reflects the current contents
+ */
+template <typename Hash, typename Value>
+bool HashTable<Hash, Value>::orderCurrent() const {
+	return m_order_generation == m_generation;
+}
+
+/**
+ * Get the ordered index, rebuilding it if the table changed since it was built
+ *
+ * @return Payload indices sorted by course number
+ */
+template <typename Hash, typename Value>
+const std::vector<unsigned int> &HashTable<Hash, Value>::order() const {
+	if (!orderCurrent()) {
+		CSC300_TIME(Sort);
+		std::vector<SortEntry> entries;
+		entries.reserve(m_keys.size());
+		for (unsigned int i = 0; i < m_keys.size(); ++i) {
+			entries.push_back(MakeSortEntry(m_keys[i], i));
+		}
+		IntroSort(entries);
+		m_order.resize(entries.size());
+		for (std::size_t i = 0; i < entries.size(); ++i) {
+			m_order[i] = entries[i].index;
+		}
+		m_order_generation = m_generation;
+		m_order_shifts = 0;
+	}
+	return m_order;
+}
+
+/**
+ * Position of a course number in a current ordered index, a binary
+ * search; inserting or erasing there shifts the rest of the index
+ *
+ * @param course_number A course number in the table
+ */
+template <typename Hash, typename Value>
+std::vector<unsigned int>::iterator HashTable<Hash, Value>::orderPosition(std::string_view course_number) const {
+	return std::lower_bound(m_order.begin(), m_order.end(), course_number, [this](unsigned int i, std::string_view number) {
+		return std::string_view { m_keys[i] } < number;
+	});
+}
+
+/**
+ * Call fn(const Value &) for every course in course number order.
+ * O(n) and allocation free once the ordered index is built.
+ *
+ * @param fn The function to call
+ */
+template <typename Hash, typename Value>
+template <typename F>
+void HashTable<Hash, Value>::for_each_ordered(F &&fn) const {
+	for (unsigned int index : order()) {
+		fn(m_courses[index]);
+	}
+}
+
+/**
+ * @return Every course, in course number order
+ */
+template <typename Hash, typename Value>
+typename HashTable<Hash, Value>::OrderedRange HashTable<Hash, Value>::ordered() const {
+	const std::vector<unsigned int> &index { order() };
+	return { this, index.begin(), index.end() };
+}
+
+/**
+ * Courses numbered in [first, last), in order.
+ * For example ("CSCI300", "CSCI400") is every CSCI 3xx course.
+ * O(log n) to create, then O(1) per result.
+ *
+ * @param first The lowest course number to include
+ * @param last The course number to stop before
+ */
+template <typename Hash, typename Value>
+typename HashTable<Hash, Value>::OrderedRange HashTable<Hash, Value>::range(std::string_view first, std::string_view last) const {
+	const std::vector<unsigned int> &index { order() };
+	auto below = [this](unsigned int i, std::string_view number) {
+		return std::string_view { m_keys[i] } < number;
+	};
+	auto begin { std::lower_bound(index.begin(), index.end(), first, below) };
+	return { this, begin, std::lower_bound(begin, index.end(), last, below) };
+}
+
+/**
+ * Courses numbered first or later, in order
+ *
+ * @param first The lowest course number to include
+ */
+template <typename Hash, typename Value>
+typename HashTable<Hash, Value>::OrderedRange HashTable<Hash, Value>::rangeFrom(std::string_view first) const {
+	const std::vector<unsigned int> &index { order() };
+	auto begin { std::lower_bound(index.begin(), index.end(), first, [this](unsigned int i, std::string_view number) {
+		return std::string_view { m_keys[i] } < number;
+	}) };
+	return { this, begin, index.end() };
+}
+
+/**
+ * Courses whose number starts with course_prefix, in order.
+ * For example "MATH" is every MATH course and "CSCI3" every CSCI 3xx course.
+ *
+ * @param course_prefix The prefix to match
+ */
+template <typename Hash, typename Value>
+typename HashTable<Hash, Value>::OrderedRange HashTable<Hash, Value>::prefix(std::string_view course_prefix) const {
+	std::string last { PrefixSuccessor(course_prefix) };
+	if (last.empty()) {
+		return rangeFrom(course_prefix);
+	}
+	return range(course_prefix, last);
+}
+
+/**
+ * Call fn(const Value &), in order, for every course numbered in [first, last).
+ *
+ * @param first The lowest course number to include
+ * @param last The course number to stop before
+ * @param fn The function to call
+ */
+template <typename Hash, typename Value>
+template <typename F>
+void HashTable<Hash, Value>::for_each_range(std::string_view first, std::string_view last, F &&fn) const {
+	for (const Value &course : range(first, last)) {
+		fn(course);
+	}
+}
+
+/**
+ * Count the courses numbered in [first, last) with two binary searches
+ *
+ * @param first The lowest course number to include
+ * @param last The course number to stop before
+ */
+template <typename Hash, typename Value>
+std::size_t HashTable<Hash, Value>::count_range(std::string_view first, std::string_view last) const {
+	return range(first, last).size();
+}
+
+/**
+ * @return A counter bumped by every insert and remove, for invalidating caches
+ */
+template <typename Hash, typename Value>
+std::uint64_t HashTable<Hash, Value>::generation() const {
+	return m_generation;
+}
+
+/**
+ * Scan the slot arrays for load and probe lengths. Costs a pass over
+ * every slot, and works whether or not CSC300_STATS is on.
+ *
+ * @return The table's current shape
+ */
+template <typename Hash, typename Value>
+HashTableStats HashTable<Hash, Value>::stats() const {
+	HashTableStats result;
+	result.size = size();
+	result.slots = m_slots.size();
+	result.old_slots = m_old_slots.size();
+	result.load_factor = load_factor();
+	std::uint64_t total { };
+	auto scan = [&](const std::vector<Slot> &slots) {
+		for (unsigned int pos = 0; pos < slots.size(); ++pos) {
+			if (slots[pos].index < TOMBSTONE) {
+				unsigned int dist { distance(slots, pos, slots[pos].hash) };
+				++result.probe_lengths[std::min<std::size_t>(dist, PROBE_BUCKETS - 1)];
+				result.max_probe = std::max(result.max_probe, dist);
+				total += dist;
+			}
+		}
+	};
+	scan(m_slots);
+	scan(m_old_slots);
+	result.mean_probe = result.size == 0 ? 0 : static_cast<double>(total) / result.size;
+	return result;
+}
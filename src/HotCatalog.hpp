@@ -0,0 +1,193 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+#include "CsvLoader.hpp"
+#include "Epoch.hpp"
+
+/*
+ * A catalog that can be replaced while it is being read
+ *
+ * The current table sits behind an atomic pointer. Readers pin an
+ * EpochDomain and use the table in place, so they never wait on a
+ * reload. reload() builds and validates the next table on a background
+ * thread, with any loader returning a LoadResult. If the result is ok,
+ * it is published with one pointer swap. The reload thread then waits
+ * for the readers of the old table to finish and deletes it. A failed
+ * reload keeps the current table and records the errors. Readers see
+ * either the whole old catalog or the whole new one, never a mix.
+ * apply() changes the current table in place instead, for small edits
+ * that don't warrant a reload, when no reader can be running.
+ */
+template <typename Table>
+class HotCatalog {
+	private:
+		std::atomic<Table *> m_current; // only ever read through read(), except by apply()
+		mutable EpochDomain m_epoch;
+		std::atomic<std::uint64_t> m_version { 1 };
+		std::mutex m_reload_mutex; // guards m_reloader, never taken by the reload thread
+		std::jthread m_reloader;
+		mutable std::mutex m_errors_mutex;
+		std::vector<LoadError> m_errors;
+		static Table *prepare(Table &&table);
+
+	public:
+		HotCatalog(Table &&table);
+		HotCatalog(const HotCatalog &) = delete;
+		HotCatalog &operator=(const HotCatalog &) = delete;
+		~HotCatalog();
+		template <typename F>
+		decltype(auto) read(F &&fn) const;
+		void publish(Table &&table);
+		template <typename F>
+		bool apply(F &&fn);
+		template <typename Loader>
+		void reload(Loader &&loader);
+		void wait();
+		std::vector<LoadError> errors() const;
+		std::uint64_t version() const;
+};
+
+/**
+ * @param table The first version of the catalog
+ */
+template <typename Table>
+HotCatalog<Table>::HotCatalog(Table &&table) : m_current { prepare(std::move(table)) } { }
+
+/**
+ * Move a table to the heap and build its lazy indexes, so that readers
+ * sharing it across threads only ever read it
+ *
+ * @param table The table to publish
+ */
+template <typename Table>
+Table *HotCatalog<Table>::prepare(Table &&table) {
+	Table *prepared { new Table { std::move(table) } };
+	if constexpr (requires { prepared->ordered(); }) {
+		prepared->ordered();
+	}
+	return prepared;
+}
+
+/**
+ * Finish any reload, then delete the current table
+ */
+template <typename Table>
+HotCatalog<Table>::~HotCatalog() {
+	wait();
+	delete m_current.load(std::memory_order_relaxed);
+}
+
+/**
+ * Run fn(const Table &) against the current version. The table stays
+ * alive until fn returns, even if a reload publishes meanwhile.
+ *
+ * @param fn Called with the table; must not keep references into it
+ * @return Whatever fn returns
+ */
+template <typename Table>
+template <typename F>
+decltype(auto) HotCatalog<Table>::read(F &&fn) const {
+	EpochDomain::Guard guard { m_epoch };
+	return fn(static_cast<const Table &>(*m_current.load(std::memory_order_acquire)));
+}
+
+/**
+ * Replace the catalog, then wait for readers of the old version to
+ * finish and delete it. Readers are never blocked. Must not be called
+ * from inside read(), it would wait for itself.
+ *
+ * @param table The new version
+ */
+template <typename Table>
+void HotCatalog<Table>::publish(Table &&table) {
+	Table *old { m_current.exchange(prepare(std::move(table)), std::memory_order_acq_rel) };
+	m_version.fetch_add(1, std::memory_order_relaxed);
+	m_epoch.retire(old);
+	m_epoch.synchronize();
+}
+
+/**
+ * Change the current version in place, with no copy and no swap. Any
+ * reload is finished first and none can start meanwhile. Readers are
+ * not excluded: only call it when none can be running, such as from the
+ * thread that does all the reading. Must not be called from inside
+ * read(), like publish().
+ *
+ * @param fn Called as fn(Table &) with the current table, returning
+ *        whether it changed it
+ * @return What fn returned
+ */
+template <typename Table>
+template <typename F>
+bool HotCatalog<Table>::apply(F &&fn) {
+	std::lock_guard<std::mutex> lock { m_reload_mutex };
+	if (m_reloader.joinable()) {
+		m_reloader.join();
+	}
+	Table &table { *m_current.load(std::memory_order_acquire) };
+	if (!fn(table)) {
+		return false;
+	}
+	// leave the lazy indexes built, as prepare() does
+	if constexpr (requires { table.ordered(); }) {
+		table.ordered();
+	}
+	m_version.fetch_add(1, std::memory_order_relaxed);
+	return true;
+}
+
+/**
+ * Start building a new version in the background, after any reload
+ * already running has finished
+ *
+ * @param loader Called as loader() on the reload thread, returning a
+ *        LoadResult<Table>; published only if it is ok()
+ */
+template <typename Table>
+template <typename Loader>
+void HotCatalog<Table>::reload(Loader &&loader) {
+	std::lock_guard<std::mutex> lock { m_reload_mutex };
+	if (m_reloader.joinable()) {
+		m_reloader.join();
+	}
+	m_reloader = std::jthread { [this, loader = std::forward<Loader>(loader)]() mutable {
+		LoadResult<Table> result { loader() };
+		if (result.ok()) {
+			publish(std::move(result.table));
+		}
+		std::lock_guard<std::mutex> errors_lock { m_errors_mutex };
+		m_errors = std::move(result.errors);
+	} };
+}
+
+/**
+ * Wait for the running reload, if any, to publish or fail
+ */
+template <typename Table>
+void HotCatalog<Table>::wait() {
+	std::lock_guard<std::mutex> lock { m_reload_mutex };
+	if (m_reloader.joinable()) {
+		m_reloader.join();
+	}
+}
+
+/**
+ * @return The errors of the last finished reload, empty if it succeeded
+ */
+template <typename Table>
+std::vector<LoadError> HotCatalog<Table>::errors() const {
+	std::lock_guard<std::mutex> lock { m_errors_mutex };
+	return m_errors;
+}
+
+/**
+ * @return How many versions have been published, starting at 1
+ */
+template <typename Table>
+std::uint64_t HotCatalog<Table>::version() const {
+	return m_version.load(std::memory_order_relaxed);
+}
@@ -0,0 +1,188 @@
+#include "LazyCatalog.hpp"
+#include <cstring>
+#include "CsvLoader.hpp"
+
+namespace {
+	/*
+	 * Find the number and title of a CSV line, with the field rules of
+	 * AddField, without reading past the title
+	 *
+	 * @param line The line, without its newline
+	 * @param number Receives the first non-empty field
+	 * @param title Receives the second
+	 * @return true if the line has both
+	 */
+	bool leadingFields(std::string_view line, std::string_view &number, std::string_view &title) {
+		int fields { };
+		for (std::size_t start { }; start <= line.size(); ) {
+			std::size_t end { line.find(',', start) };
+			bool last { end == std::string_view::npos };
+			std::string_view field { line.substr(start, (last ? line.size() : end) - start) };
+			if (last && !field.empty() && field.back() == '\r') {
+				field.remove_suffix(1);
+			}
+			if (!field.empty()) {
+				if (fields++ == 0) {
+					number = field;
+				} else {
+					title = field;
+					return true;
+				}
+			}
+			if (last) {
+				break;
+			}
+			start = end + 1;
+		}
+		return false;
+	}
+}
+
+/**
+ * Index a course CSV, or its snapshot when that is fresh
+ *
+ * @param file_path Path to the CSV; the snapshot is file_path + ".snapshot"
+ * @param t_capacity Decoded courses kept by find, 0 to keep only the last
+ */
+LazyCatalog::LazyCatalog(const std::string &file_path, const std::size_t &t_capacity) : m_snapshot { file_path + ".snapshot", file_path }, m_capacity { t_capacity } {
+	if (m_snapshot.is_open()) {
+		m_open = true;
+		return;
+	}
+	m_file = MappedFile { file_path };
+	if (!m_file.is_open()) {
+		return;
+	}
+	m_open = true;
+	std::string_view data { m_file.view() };
+	for (std::size_t start { }; start < data.size(); ) {
+		const void *newline { std::memchr(data.data() + start, '\n', data.size() - start) };
+		std::size_t end { newline == nullptr ? data.size() : static_cast<std::size_t>(static_cast<const char *>(newline) - data.data()) };
+		std::string_view number, title;
+		if (end - start <= UINT32_MAX && leadingFields(data.substr(start, end - start), number, title)) {
+			m_rows.insert(Row { number, start, static_cast<std::uint32_t>(end - start) });
+		}
+		start = end + 1;
+	}
+}
+
+/**
+ * @param row An indexed row
+ * @return Its line, without the newline
+ */
+std::string_view LazyCatalog::line(const Row &row) const {
+	return m_file.view().substr(row.offset, row.length);
+}
+
+/**
+ * Parse a course out of its row or the snapshot
+ *
+ * @param course_number The course number
+ * @return The course, or an empty course if it isn't in the catalog
+ */
+Course LazyCatalog::decode(std::string_view course_number) const {
+	if (m_snapshot.is_open()) {
+		ArenaCourse course { m_snapshot.search(course_number) };
+		return course.id == CourseIds::INVALID ? Course { } : m_snapshot.toCourse(course);
+	}
+	const Row *row { m_rows.find(course_number) };
+	if (row == nullptr) {
+		return { };
+	}
+	CsvRow fields;
+	SplitRow(line(*row), fields);
+	return { std::string { fields.number }, std::string { fields.title }, { fields.prerequisites.begin(), fields.prerequisites.end() } };
+}
+
+/**
+ * @return Whether the CSV or its snapshot could be opened
+ */
+bool LazyCatalog::is_open() const {
+	return m_open;
+}
+
+/**
+ * @return Whether courses come from a snapshot rather than the CSV
+ */
+bool LazyCatalog::from_snapshot() const {
+	return m_snapshot.is_open();
+}
+
+/**
+ * @return The number of courses
+ */
+std::size_t LazyCatalog::size() const {
+	return m_snapshot.is_open() ? m_snapshot.size() : m_rows.size();
+}
+
+/**
+ * Check whether a course exists, nothing is decoded
+ *
+ * @param course_number The course number to search for
+ */
+bool LazyCatalog::contains(std::string_view course_number) const {
+	return m_snapshot.is_open() ? m_snapshot.contains(course_number) : m_rows.contains(course_number);
+}
+
+/**
+ * Read a course's title in place, without decoding its prerequisites
+ *
+ * @param course_number The course number to search for
+ * @return The title, a view into the mapping, or empty if not found
+ */
+std::string_view LazyCatalog::title(std::string_view course_number) const {
+	if (m_snapshot.is_open()) {
+		return m_snapshot.search(course_number).title;
+	}
+	const Row *row { m_rows.find(course_number) };
+	if (row == nullptr) {
+		return { };
+	}
+	std::string_view number, title;
+	leadingFields(line(*row), number, title);
+	return title;
+}
+
+/**
+ * Find a course, decoding it on first access
+ *
+ * @param course_number The course number to search for
+ * @return The course, or nullptr if not found. Valid until capacity
+ *         other courses have been found since, or the next find with a
+ *         capacity of 0.
+ */
+const Course *LazyCatalog::find(std::string_view course_number) {
+	auto cached { m_cached.find(course_number) };
+	if (cached != m_cached.end()) {
+		m_cache.splice(m_cache.begin(), m_cache, cached->second);
+		return &*cached->second;
+	}
+	if (!contains(course_number)) {
+		return nullptr;
+	}
+	if (m_cache.size() >= std::max<std::size_t>(m_capacity, 1)) {
+		m_cached.erase(m_cache.back().number);
+		m_cache.pop_back();
+	}
+	m_cache.push_front(decode(course_number));
+	m_cached.emplace(m_cache.front().number, m_cache.begin());
+	return &m_cache.front();
+}
+
+/**
+ * Search for a course, decoding it on first access
+ *
+ * @param course_number The course number to search for
+ * @return A copy of the course, or an empty course if not found
+ */
+Course LazyCatalog::search(std::string_view course_number) {
+	const Course *course { find(course_number) };
+	return course != nullptr ? *course : Course { };
+}
+
+/**
+ * @return The number of decoded courses held by the cache
+ */
+std::size_t LazyCatalog::cached() const {
+	return m_cache.size();
+}
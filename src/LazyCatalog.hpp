@@ -0,0 +1,61 @@
+#pragma once
+#include <cstdint>
+#include <list>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include "Course.hpp"
+#include "HashTable.hpp"
+#include "MappedFile.hpp"
+#include "Snapshot.hpp"
+
+/*
+ * Course catalog that decodes rows on first access
+ *
+ * Opening maps the CSV and indexes only where each row starts and its
+ * course number, as views into the mapping; titles and prerequisites
+ * are not parsed and no strings are allocated. title() reads a row's
+ * title in place, find() decodes a whole Course and keeps the most
+ * recently used ones in a small LRU cache. When the CSV has a fresh
+ * snapshot (see Snapshot.hpp) the snapshot's index is used instead and
+ * the CSV is not read at all.
+ *
+ * Rows with fewer than two fields are not courses, as in LoadCatalog,
+ * and a later row replaces an earlier one with the same number. Other
+ * problems, such as missing prerequisites, are not checked; validate
+ * with ValidateCatalog when that matters. Lookups update the cache, so
+ * a LazyCatalog must not be shared between threads.
+ */
+class LazyCatalog {
+	private:
+		// a row's place in the mapping, keyed by its number
+		struct Row {
+			std::string_view number;
+			std::size_t offset;
+			std::uint32_t length; // without the newline
+		};
+		MappedFile m_file;
+		CatalogSnapshot m_snapshot;
+		HashTable<WyHash, Row> m_rows;
+		bool m_open { false };
+		std::size_t m_capacity;
+		// most recently used first; the map's keys view the cached courses' numbers
+		std::list<Course> m_cache;
+		std::unordered_map<std::string_view, std::list<Course>::iterator> m_cached;
+		std::string_view line(const Row &row) const;
+		Course decode(std::string_view course_number) const;
+
+	public:
+		static constexpr std::size_t DEFAULT_CACHE { 64 };
+		LazyCatalog(const std::string &file_path, const std::size_t &t_capacity = DEFAULT_CACHE);
+		LazyCatalog(const LazyCatalog &) = delete;
+		LazyCatalog &operator=(const LazyCatalog &) = delete;
+		bool is_open() const;
+		bool from_snapshot() const;
+		std::size_t size() const;
+		bool contains(std::string_view course_number) const;
+		std::string_view title(std::string_view course_number) const;
+		const Course *find(std::string_view course_number);
+		Course search(std::string_view course_number);
+		std::size_t cached() const;
+};
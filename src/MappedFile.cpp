@@ -0,0 +1,109 @@
+#include "MappedFile.hpp"
+#include <fstream>
+#include <sstream>
+#include <utility>
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define CSC300_HAVE_MMAP 1
+#endif
+
+/**
+ * Map a file
+ *
+ * @param file_path The file to map
+ */
+MappedFile::MappedFile(const std::string &file_path) {
+#ifdef CSC300_HAVE_MMAP
+	int fd { ::open(file_path.c_str(), O_RDONLY) };
+	if (fd < 0) {
+		return;
+	}
+	struct stat info { };
+	if (::fstat(fd, &info) == 0) {
+		m_size = static_cast<std::size_t>(info.st_size);
+		m_open = true;
+		// mmap rejects empty mappings, an empty file is just an empty view
+		if (m_size > 0) {
+			void *addr { ::mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0) };
+			if (addr == MAP_FAILED) {
+				m_open = false;
+				m_size = 0;
+			} else {
+				::madvise(addr, m_size, MADV_SEQUENTIAL);
+				m_data = static_cast<const char *>(addr);
+				m_mapped = true;
+			}
+		}
+	}
+	::close(fd);
+#else
+	std::ifstream file { file_path, std::ios::binary };
+	if (!file.is_open()) {
+		return;
+	}
+	std::ostringstream contents;
+	contents << file.rdbuf();
+	m_buffer = contents.str();
+	m_data = m_buffer.data();
+	m_size = m_buffer.size();
+	m_open = true;
+#endif
+}
+
+MappedFile::MappedFile(MappedFile &&other) noexcept {
+	*this = std::move(other);
+}
+
+MappedFile &MappedFile::operator=(MappedFile &&other) noexcept {
+	if (this != &other) {
+		close();
+		m_buffer = std::move(other.m_buffer);
+		m_size = std::exchange(other.m_size, 0);
+		m_open = std::exchange(other.m_open, false);
+		m_mapped = std::exchange(other.m_mapped, false);
+		// a fallback buffer moved with the string, re-point at it
+		m_data = m_mapped ? other.m_data : m_buffer.data();
+		other.m_data = nullptr;
+	}
+	return *this;
+}
+
+/**
+ * Destructor
+ */
+MappedFile::~MappedFile() {
+	close();
+}
+
+/**
+ * Unmap the file and reset to the closed state
+ */
+void MappedFile::close() {
+#ifdef CSC300_HAVE_MMAP
+	if (m_mapped) {
+		::munmap(const_cast<char *>(m_data), m_size);
+	}
+#endif
+	m_buffer.clear();
+	m_data = nullptr;
+	m_size = 0;
+	m_open = false;
+	m_mapped = false;
+}
+
+/**
+ * @return true if the file was opened
+ */
+bool MappedFile::is_open() const {
+	return m_open;
+}
+
+/**
+ * @return The file contents
+ */
+std::string_view MappedFile::view() const {
+	return { m_data, m_size };
+}
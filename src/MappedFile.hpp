@@ -0,0 +1,30 @@
+#pragma once
+#include <string>
+#include <string_view>
+
+/*
+ * Read-only memory mapping of a whole file
+ *
+ * Falls back to reading the file into memory where mmap is unavailable.
+ * Check is_open() after construction, like std::ifstream.
+ */
+class MappedFile {
+	private:
+		const char *m_data { nullptr };
+		std::size_t m_size { };
+		bool m_open { false };
+		bool m_mapped { false }; // false when m_data points into m_buffer
+		std::string m_buffer;
+		void close();
+
+	public:
+		MappedFile() = default;
+		MappedFile(const std::string &file_path);
+		MappedFile(const MappedFile &) = delete;
+		MappedFile &operator=(const MappedFile &) = delete;
+		MappedFile(MappedFile &&other) noexcept;
+		MappedFile &operator=(MappedFile &&other) noexcept;
+		~MappedFile();
+		bool is_open() const;
+		std::string_view view() const;
+};
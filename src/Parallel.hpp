@@ -0,0 +1,46 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+/*
+ * Run fn(i) for every i in [0, count) on up to threads threads.
+ * Tasks are handed out one at a time from a shared counter so uneven
+ * tasks balance out; the calling thread works too. Runs inline when
+ * threads or count is 1.
+ *
+ * @param count The number of tasks
+ * @param threads The maximum number of threads to use
+ * @param fn Called once per task index, possibly concurrently
+ */
+template <typename F>
+void ParallelFor(const std::size_t &count, const unsigned int &threads, F &&fn) {
+	std::size_t workers { std::min<std::size_t>(std::max(1u, threads), count) };
+	if (workers <= 1) {
+		for (std::size_t i = 0; i < count; ++i) {
+			fn(i);
+		}
+		return;
+	}
+	std::atomic<std::size_t> next { 0 };
+	auto work = [&]() {
+		for (std::size_t i; (i = next.fetch_add(1, std::memory_order_relaxed)) < count; ) {
+			fn(i);
+		}
+	};
+	std::vector<std::jthread> pool;
+	pool.reserve(workers - 1);
+	for (std::size_t t = 1; t < workers; ++t) {
+		pool.emplace_back(work);
+	}
+	work();
+}
+
+/*
+ * Threads to use when the caller asks for "all cores"
+ */
+inline unsigned int DefaultThreadCount() {
+	return std::max(1u, std::thread::hardware_concurrency());
+}
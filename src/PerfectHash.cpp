@@ -0,0 +1,134 @@
+#include "PerfectHash.hpp"
+#include <algorithm>
+#include <numeric>
+
+using namespace perfect_hash_detail;
+
+/**
+ * Adopt a perfect hash built earlier
+ *
+ * @param t_seed Its seed
+ * @param t_size The number of keys
+ * @param t_pilots Its pilots
+ */
+PerfectHash::PerfectHash(const std::uint64_t &t_seed, const std::uint32_t &t_size, std::vector<std::uint32_t> t_pilots)
+	: m_seed { t_seed }, m_size { t_size }, m_pilots { std::move(t_pilots) } { }
+
+/**
+ * Build a perfect hash over distinct keys. A set holding the same key
+ * twice can never be placed, and fails once each of MAX_SEEDS seeds
+ * has hashed the two together.
+ *
+ * @param keys The keys, each once
+ * @return false if no placement was found, leaving the hash empty
+ */
+bool PerfectHash::build(std::span<const std::string_view> keys) {
+	*this = PerfectHash { };
+	if (keys.size() >= UINT32_MAX) {
+		return false;
+	}
+	std::vector<std::uint64_t> hashes(keys.size());
+	for (int attempt = 0; attempt < MAX_SEEDS; ++attempt) {
+		m_seed = 0x2545f4914f6cdd1dull * (attempt + 1);
+		for (std::size_t i = 0; i < keys.size(); ++i) {
+			hashes[i] = keyHash(m_seed, keys[i]);
+		}
+		if (place(hashes)) {
+			return true;
+		}
+	}
+	*this = PerfectHash { };
+	return false;
+}
+
+/**
+ * Find a pilot for every bucket under the current seed
+ *
+ * @param hashes The key hashes
+ * @return false if some bucket ran out of pilots
+ */
+bool PerfectHash::place(std::span<const std::uint64_t> hashes) {
+	m_size = static_cast<std::uint32_t>(hashes.size());
+	std::size_t buckets { std::max<std::size_t>(1, (hashes.size() + BUCKET_SIZE - 1) / BUCKET_SIZE) };
+	m_pilots.assign(buckets, 0);
+	// keys grouped by bucket: counting sort of key indices
+	std::vector<std::uint32_t> starts(buckets + 1), keys(hashes.size());
+	for (std::uint64_t hash : hashes) {
+		++starts[bucket(hash, buckets) + 1];
+	}
+	std::partial_sum(starts.begin(), starts.end(), starts.begin());
+	{
+		std::vector<std::uint32_t> next { starts.begin(), starts.end() - 1 };
+		for (std::uint32_t i = 0; i < hashes.size(); ++i) {
+			keys[next[bucket(hashes[i], buckets)]++] = i;
+		}
+	}
+	std::vector<std::uint32_t> order(buckets);
+	std::iota(order.begin(), order.end(), 0);
+	std::stable_sort(order.begin(), order.end(), [&](std::uint32_t a, std::uint32_t b) {
+		return starts[a + 1] - starts[a] > starts[b + 1] - starts[b];
+	});
+	std::vector<bool> taken(hashes.size());
+	std::vector<std::uint32_t> positions;
+	const std::uint32_t max_pilot { static_cast<std::uint32_t>(std::min<std::uint64_t>(UINT32_MAX, std::max<std::uint64_t>(MIN_PILOTS, 16ull * m_size))) };
+	for (std::uint32_t b : order) {
+		std::span<const std::uint32_t> members { keys.data() + starts[b], starts[b + 1] - starts[b] };
+		if (members.empty()) {
+			break; // sorted largest first, the rest are empty too
+		}
+		// keys with the same hash land together under every pilot
+		for (std::size_t i = 0; i < members.size(); ++i) {
+			for (std::size_t j = i + 1; j < members.size(); ++j) {
+				if (hashes[members[i]] == hashes[members[j]]) {
+					return false;
+				}
+			}
+		}
+		std::uint32_t pilot { };
+		for (; pilot < max_pilot; ++pilot) {
+			positions.clear();
+			bool fits { true };
+			for (std::uint32_t key : members) {
+				std::uint32_t pos { slot(hashes[key], pilot, m_size) };
+				// free, and not taken by an earlier key of this bucket
+				if (taken[pos] || std::find(positions.begin(), positions.end(), pos) != positions.end()) {
+					fits = false;
+					break;
+				}
+				positions.push_back(pos);
+			}
+			if (fits) {
+				break;
+			}
+		}
+		if (pilot == max_pilot) {
+			return false;
+		}
+		m_pilots[b] = pilot;
+		for (std::uint32_t pos : positions) {
+			taken[pos] = true;
+		}
+	}
+	return true;
+}
+
+/**
+ * @return The seed the keys were hashed with
+ */
+std::uint64_t PerfectHash::seed() const {
+	return m_seed;
+}
+
+/**
+ * @return The number of keys, and of positions
+ */
+std::uint32_t PerfectHash::size() const {
+	return m_size;
+}
+
+/**
+ * @return One pilot per bucket
+ */
+std::span<const std::uint32_t> PerfectHash::pilots() const {
+	return m_pilots;
+}
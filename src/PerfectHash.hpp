@@ -0,0 +1,90 @@
+#pragma once
+#include <cstdint>
+#include <span>
+#include <string_view>
+#include <vector>
+#include "Hash.hpp"
+
+/*
+ * Minimal perfect hash over a fixed set of course numbers
+ *
+ * PTHash style: keys are hashed once and split into buckets of about
+ * BUCKET_SIZE keys. Buckets are placed largest first; each gets the
+ * smallest pilot that sends all of its keys to positions no earlier
+ * bucket took. A lookup hashes the key, reads its bucket's pilot and
+ * remixes the two into a position, so every key of the set maps to its
+ * own position in [0, size()) with no empty positions, and a key
+ * outside the set maps to some position whose key it must be compared
+ * against. Pilots take 4 bytes per bucket, about one byte per key.
+ *
+ * The seed, size and pilots are all a lookup needs, so they can be
+ * written out (see Snapshot.hpp) and used in place through position().
+ */
+namespace perfect_hash_detail {
+	constexpr std::uint32_t BUCKET_SIZE { 4 }; // mean keys per bucket
+	// pilots tried per bucket before reseeding, at least 16 per key: the
+	// last buckets have one free position left to hit
+	constexpr std::uint32_t MIN_PILOTS { 1u << 24 };
+	constexpr int MAX_SEEDS { 8 };
+
+	// x scaled from [0, 2^64) to [0, n) without a division
+	inline std::uint64_t reduce(const std::uint64_t &x, const std::uint64_t &n) {
+#if defined(__SIZEOF_INT128__)
+		return static_cast<std::uint64_t>((static_cast<__uint128_t>(x) * n) >> 64);
+#else
+		return x % n;
+#endif
+	}
+
+	inline std::uint64_t keyHash(const std::uint64_t &seed, std::string_view key) {
+		return hash_detail::mum(WyHash {}(key) ^ seed, 0x9e3779b97f4a7c15ull);
+	}
+
+	inline std::uint32_t slot(const std::uint64_t &hash, const std::uint32_t &pilot, const std::uint32_t &size) {
+		return static_cast<std::uint32_t>(reduce(hash_detail::mum(hash ^ 0xe7037ed1a0b428dbull, pilot ^ 0x8ebc6af09c88c6e3ull), size));
+	}
+
+	inline std::uint32_t bucket(const std::uint64_t &hash, const std::size_t &buckets) {
+		return static_cast<std::uint32_t>(reduce(hash, buckets));
+	}
+}
+
+class PerfectHash {
+	private:
+		std::uint64_t m_seed { };
+		std::uint32_t m_size { };
+		std::vector<std::uint32_t> m_pilots;
+		bool place(std::span<const std::uint64_t> hashes);
+
+	public:
+		PerfectHash() = default;
+		PerfectHash(const std::uint64_t &t_seed, const std::uint32_t &t_size, std::vector<std::uint32_t> t_pilots);
+		bool build(std::span<const std::string_view> keys);
+		std::uint32_t operator()(std::string_view key) const;
+		static std::uint32_t position(const std::uint64_t &seed, std::span<const std::uint32_t> pilots, const std::uint32_t &size, std::string_view key);
+		std::uint64_t seed() const;
+		std::uint32_t size() const;
+		std::span<const std::uint32_t> pilots() const;
+};
+
+/**
+ * Position of a key, for a perfect hash stored elsewhere
+ *
+ * @param seed The hash's seed
+ * @param pilots Its pilots, not empty when size is not 0
+ * @param size The number of keys it was built over
+ * @param key The key
+ * @return The key's position if it is in the set, else any position below size
+ */
+inline std::uint32_t PerfectHash::position(const std::uint64_t &seed, std::span<const std::uint32_t> pilots, const std::uint32_t &size, std::string_view key) {
+	std::uint64_t hash { perfect_hash_detail::keyHash(seed, key) };
+	return perfect_hash_detail::slot(hash, pilots[perfect_hash_detail::bucket(hash, pilots.size())], size);
+}
+
+/**
+ * @param key A key
+ * @return Its position if it is in the set, else any position below size()
+ */
+inline std::uint32_t PerfectHash::operator()(std::string_view key) const {
+	return position(m_seed, m_pilots, m_size, key);
+}
@@ -0,0 +1,471 @@
+#include "PrerequisiteGraph.hpp"
+#include <algorithm>
+#include <iterator>
+#include <unordered_set>
+
+/**
+ * Add a course, or get the vertex of one already added
+ *
+ * @param number The course number
+ * @return Its vertex id
+ */
+std::uint32_t PrerequisiteGraph::addCourse(std::string_view number) {
+	return m_ids.intern(number);
+}
+
+/**
+ * Record that course requires prerequisite. Takes effect on build.
+ *
+ * @param course The vertex id of the course
+ * @param prerequisite The prerequisite's course number, added if new
+ */
+void PrerequisiteGraph::addPrerequisite(const std::uint32_t &course, std::string_view prerequisite) {
+	m_pending.emplace_back(course, m_ids.intern(prerequisite));
+}
+
+/**
+ * @param v A vertex id, below the row count
+ * @return Its row
+ */
+std::span<const std::uint32_t> PrerequisiteGraph::Rows::row(const std::uint32_t &v) const {
+	return std::span<const std::uint32_t> { data }.subspan(begin[v], end[v] - begin[v]);
+}
+
+/**
+ * Lay out every row at once, in edge order
+ *
+ * @param n The number of rows
+ * @param edges (course, prerequisite) pairs
+ * @param reverse false to file each prerequisite under its course,
+ *        true to file each course under its prerequisite
+ */
+void PrerequisiteGraph::Rows::layout(const std::size_t &n, std::span<const std::pair<std::uint32_t, std::uint32_t>> edges, const bool &reverse) {
+	std::vector<std::uint32_t> offsets(n + 1, 0);
+	for (const auto &[course, prerequisite] : edges) {
+		++offsets[(reverse ? prerequisite : course) + 1];
+	}
+	for (std::size_t v = 0; v < n; ++v) {
+		offsets[v + 1] += offsets[v];
+	}
+	begin.assign(offsets.begin(), offsets.end() - 1);
+	end.assign(offsets.begin(), offsets.end() - 1);
+	data.resize(edges.size());
+	for (const auto &[course, prerequisite] : edges) {
+		data[end[reverse ? prerequisite : course]++] = reverse ? course : prerequisite;
+	}
+	live = data.size();
+}
+
+/**
+ * Replace a row, appending the new one
+ *
+ * @param v A vertex id, below the row count
+ * @param ids The new row, not a view into data
+ */
+void PrerequisiteGraph::Rows::assign(const std::uint32_t &v, std::span<const std::uint32_t> ids) {
+	live += ids.size();
+	live -= end[v] - begin[v];
+	begin[v] = static_cast<std::uint32_t>(data.size());
+	data.insert(data.end(), ids.begin(), ids.end());
+	end[v] = static_cast<std::uint32_t>(data.size());
+}
+
+/**
+ * Drop stale ranges once they are more than half of data, so repacking
+ * costs O(1) amortized per id assigned
+ */
+void PrerequisiteGraph::Rows::compact() {
+	if (data.size() <= live * 2 + 1024) {
+		return;
+	}
+	std::vector<std::uint32_t> packed;
+	packed.reserve(live);
+	for (std::size_t v = 0; v < begin.size(); ++v) {
+		std::uint32_t first { static_cast<std::uint32_t>(packed.size()) };
+		packed.insert(packed.end(), data.begin() + begin[v], data.begin() + end[v]);
+		begin[v] = first;
+		end[v] = static_cast<std::uint32_t>(packed.size());
+	}
+	data = std::move(packed);
+}
+
+/**
+ * Lay out the edges, then compute the topological order, terms and
+ * transitive closures. Call once after adding every course.
+ */
+void PrerequisiteGraph::build() {
+	const std::uint32_t n { static_cast<std::uint32_t>(m_ids.size()) };
+	// rows of direct prerequisites and their reverse, duplicates dropped
+	std::sort(m_pending.begin(), m_pending.end());
+	m_pending.erase(std::unique(m_pending.begin(), m_pending.end()), m_pending.end());
+	m_edges.layout(n, m_pending, false);
+	m_dependents.layout(n, m_pending, true);
+	m_pending.clear();
+	m_pending.shrink_to_fit();
+	m_cleared.clear();
+	m_affected.assign(n, INVALID);
+
+	// Kahn's algorithm: a course is ready once all its prerequisites are
+	// ordered, whatever is never ready is on or behind a cycle
+	std::vector<std::uint32_t> remaining(n);
+	m_order.clear();
+	m_order.reserve(n);
+	m_order_stale = false;
+	for (std::uint32_t v = 0; v < n; ++v) {
+		remaining[v] = static_cast<std::uint32_t>(m_edges.row(v).size());
+		if (remaining[v] == 0) {
+			m_order.push_back(v);
+		}
+	}
+	for (std::size_t i = 0; i < m_order.size(); ++i) {
+		for (std::uint32_t dependent : m_dependents.row(m_order[i])) {
+			if (--remaining[dependent] == 0) {
+				m_order.push_back(dependent);
+			}
+		}
+	}
+	m_cyclic.clear();
+	for (std::uint32_t v = 0; v < n; ++v) {
+		if (remaining[v] != 0) {
+			m_cyclic.push_back(v);
+		}
+	}
+
+	m_terms.assign(n, INVALID);
+	m_closure.begin.assign(n, 0);
+	m_closure.end.assign(n, 0);
+	std::vector<std::uint32_t> &closure { m_closure.data };
+	closure.clear();
+	std::vector<std::uint32_t> added(n, INVALID); // added[x] == v once x is in v's closure
+	auto add = [&](const std::uint32_t &v, const std::uint32_t &x) {
+		if (added[x] != v) {
+			added[x] = v;
+			closure.push_back(x);
+		}
+	};
+	// in order each prerequisite's closure is final before it is merged,
+	// indices rather than iterators since the closures grow while merging
+	for (std::uint32_t v : m_order) {
+		std::uint32_t term { 0 };
+		m_closure.begin[v] = static_cast<std::uint32_t>(closure.size());
+		for (std::uint32_t p : m_edges.row(v)) {
+			term = std::max(term, m_terms[p] + 1);
+			add(v, p);
+			for (std::uint32_t i = m_closure.begin[p]; i < m_closure.end[p]; ++i) {
+				add(v, closure[i]);
+			}
+		}
+		m_terms[v] = term;
+		m_closure.end[v] = static_cast<std::uint32_t>(closure.size());
+		std::sort(closure.begin() + m_closure.begin[v], closure.end());
+	}
+	// courses on or behind a cycle have no usable order, search each one
+	std::vector<std::uint32_t> stack;
+	for (std::uint32_t v : m_cyclic) {
+		m_closure.begin[v] = static_cast<std::uint32_t>(closure.size());
+		stack.assign(m_edges.row(v).begin(), m_edges.row(v).end());
+		while (!stack.empty()) {
+			std::uint32_t x { stack.back() };
+			stack.pop_back();
+			if (added[x] == v) {
+				continue;
+			}
+			add(v, x);
+			stack.insert(stack.end(), m_edges.row(x).begin(), m_edges.row(x).end());
+		}
+		m_closure.end[v] = static_cast<std::uint32_t>(closure.size());
+		std::sort(closure.begin() + m_closure.begin[v], closure.end());
+	}
+	m_closure.live = closure.size();
+}
+
+/**
+ * Drop a course's direct prerequisites, for a course that was removed
+ * or is about to get new ones with addPrerequisite. Takes effect on
+ * update(), prerequisites added before clearing included.
+ *
+ * @param course The vertex id of the course
+ */
+void PrerequisiteGraph::clearPrerequisites(const std::uint32_t &course) {
+	m_cleared.push_back(course);
+}
+
+/**
+ * Apply the prerequisites added and cleared since build() or the last
+ * update(). Only the changed courses and the courses depending on
+ * them, directly or not, can get a new closure, term or place in the
+ * order; they are found through the reverse rows and recomputed, every
+ * other vertex keeps what it has. order() is rebuilt from the terms the
+ * next time it is asked for.
+ *
+ * @return The number of vertices recomputed
+ */
+std::size_t PrerequisiteGraph::update() {
+	const std::uint32_t n { static_cast<std::uint32_t>(m_ids.size()) };
+	const std::uint32_t old_n { static_cast<std::uint32_t>(m_terms.size()) };
+	for (Rows *rows : { &m_edges, &m_dependents, &m_closure }) {
+		rows->begin.resize(n, 0);
+		rows->end.resize(n, 0);
+	}
+	m_terms.resize(n, 0);
+	m_affected.resize(n, INVALID);
+	std::sort(m_pending.begin(), m_pending.end());
+	m_pending.erase(std::unique(m_pending.begin(), m_pending.end()), m_pending.end());
+	std::sort(m_cleared.begin(), m_cleared.end());
+	m_cleared.erase(std::unique(m_cleared.begin(), m_cleared.end()), m_cleared.end());
+	std::vector<std::uint32_t> changed { m_cleared };
+	for (const auto &edge : m_pending) {
+		changed.push_back(edge.first);
+	}
+	std::sort(changed.begin(), changed.end());
+	changed.erase(std::unique(changed.begin(), changed.end()), changed.end());
+
+	std::vector<std::uint32_t> affected; // m_affected[affected[i]] == i
+	auto affect = [&](const std::uint32_t &v) {
+		if (m_affected[v] == INVALID) {
+			m_affected[v] = static_cast<std::uint32_t>(affected.size());
+			affected.push_back(v);
+		}
+	};
+	// new vertices have no place in the order yet
+	for (std::uint32_t v = old_n; v < n; ++v) {
+		affect(v);
+	}
+	// rewrite each changed row and patch the reverse rows it touches;
+	// m_pending and changed are both sorted by course
+	std::vector<std::uint32_t> old, next, patched;
+	auto pending { m_pending.cbegin() };
+	for (std::uint32_t v : changed) {
+		old.assign(m_edges.row(v).begin(), m_edges.row(v).end());
+		next.clear();
+		if (!std::binary_search(m_cleared.begin(), m_cleared.end(), v)) {
+			next = old;
+		}
+		for (; pending != m_pending.cend() && pending->first == v; ++pending) {
+			next.push_back(pending->second);
+		}
+		std::sort(next.begin(), next.end());
+		next.erase(std::unique(next.begin(), next.end()), next.end());
+		for (std::uint32_t p : old) {
+			if (!std::binary_search(next.begin(), next.end(), p)) {
+				std::span<const std::uint32_t> row { m_dependents.row(p) };
+				patched.clear();
+				std::remove_copy(row.begin(), row.end(), std::back_inserter(patched), v);
+				m_dependents.assign(p, patched);
+			}
+		}
+		for (std::uint32_t p : next) {
+			if (!std::binary_search(old.begin(), old.end(), p)) {
+				std::span<const std::uint32_t> row { m_dependents.row(p) };
+				patched.assign(row.begin(), row.end());
+				patched.insert(std::lower_bound(patched.begin(), patched.end(), v), v);
+				m_dependents.assign(p, patched);
+			}
+		}
+		m_edges.assign(v, next);
+		affect(v);
+	}
+	m_pending.clear();
+	m_cleared.clear();
+	// everything depending on a changed course, the list grows as it is walked
+	for (std::size_t i = 0; i < affected.size(); ++i) {
+		for (std::uint32_t dependent : m_dependents.row(affected[i])) {
+			affect(dependent);
+		}
+	}
+
+	// Kahn's algorithm over the affected vertices only; a prerequisite
+	// outside them is already final, and never ready if it is cyclic
+	std::vector<std::uint32_t> remaining(affected.size());
+	std::vector<std::uint32_t> order;
+	for (std::size_t i = 0; i < affected.size(); ++i) {
+		for (std::uint32_t p : m_edges.row(affected[i])) {
+			remaining[i] += m_affected[p] != INVALID || m_terms[p] == INVALID;
+		}
+		if (remaining[i] == 0) {
+			order.push_back(affected[i]);
+		}
+	}
+	for (std::size_t i = 0; i < order.size(); ++i) {
+		for (std::uint32_t dependent : m_dependents.row(order[i])) {
+			if (--remaining[m_affected[dependent]] == 0) {
+				order.push_back(dependent);
+			}
+		}
+	}
+	std::vector<std::uint32_t> closure;
+	for (std::uint32_t v : order) {
+		std::uint32_t term { 0 };
+		closure.clear();
+		for (std::uint32_t p : m_edges.row(v)) {
+			term = std::max(term, m_terms[p] + 1);
+			closure.push_back(p);
+			closure.insert(closure.end(), m_closure.row(p).begin(), m_closure.row(p).end());
+		}
+		std::sort(closure.begin(), closure.end());
+		closure.erase(std::unique(closure.begin(), closure.end()), closure.end());
+		m_terms[v] = term;
+		m_closure.assign(v, closure);
+	}
+	// the rest is on or behind a cycle; a search stops at unaffected
+	// vertices, whose closures are final
+	std::vector<std::uint32_t> cyclic, stack;
+	std::unordered_set<std::uint32_t> seen;
+	for (std::size_t i = 0; i < affected.size(); ++i) {
+		if (remaining[i] == 0) {
+			continue;
+		}
+		std::uint32_t v { affected[i] };
+		cyclic.push_back(v);
+		closure.clear();
+		seen.clear();
+		stack.assign(m_edges.row(v).begin(), m_edges.row(v).end());
+		while (!stack.empty()) {
+			std::uint32_t x { stack.back() };
+			stack.pop_back();
+			if (!seen.insert(x).second) {
+				continue;
+			}
+			closure.push_back(x);
+			if (m_affected[x] == INVALID) {
+				closure.insert(closure.end(), m_closure.row(x).begin(), m_closure.row(x).end());
+			} else {
+				stack.insert(stack.end(), m_edges.row(x).begin(), m_edges.row(x).end());
+			}
+		}
+		std::sort(closure.begin(), closure.end());
+		closure.erase(std::unique(closure.begin(), closure.end()), closure.end());
+		m_terms[v] = INVALID;
+		m_closure.assign(v, closure);
+	}
+
+	m_order_stale = true;
+	std::erase_if(m_cyclic, [this](const std::uint32_t &v) {
+		return m_affected[v] != INVALID;
+	});
+	m_cyclic.insert(m_cyclic.end(), cyclic.begin(), cyclic.end());
+	std::sort(m_cyclic.begin(), m_cyclic.end());
+	for (std::uint32_t v : affected) {
+		m_affected[v] = INVALID;
+	}
+	m_edges.compact();
+	m_dependents.compact();
+	m_closure.compact();
+	return affected.size();
+}
+
+/**
+ * @param number The course number
+ * @return Its vertex id, INVALID if it is not in the graph
+ */
+std::uint32_t PrerequisiteGraph::id(std::string_view number) const {
+	return m_ids.find(number);
+}
+
+/**
+ * @param id A vertex id
+ * @return Its course number
+ */
+std::string_view PrerequisiteGraph::number(const std::uint32_t &id) const {
+	return m_ids.number(id);
+}
+
+/**
+ * @return The number of vertices, courses and prerequisites alike
+ */
+std::size_t PrerequisiteGraph::size() const {
+	return m_ids.size();
+}
+
+/**
+ * @param id A vertex id
+ * @return Its direct prerequisites, empty for an unknown id
+ */
+std::span<const std::uint32_t> PrerequisiteGraph::prerequisites(const std::uint32_t &id) const {
+	return id < m_edges.begin.size() ? m_edges.row(id) : std::span<const std::uint32_t> { };
+}
+
+/**
+ * @param id A vertex id
+ * @return The courses naming it as a direct prerequisite, sorted by id,
+ *         empty for an unknown id
+ */
+std::span<const std::uint32_t> PrerequisiteGraph::dependents(const std::uint32_t &id) const {
+	return id < m_dependents.begin.size() ? m_dependents.row(id) : std::span<const std::uint32_t> { };
+}
+
+/**
+ * @param id A vertex id
+ * @return Every prerequisite needed before it, transitively, sorted by id.
+ *         Includes id itself when it is on a cycle.
+ */
+std::span<const std::uint32_t> PrerequisiteGraph::closure(const std::uint32_t &id) const {
+	return id < m_closure.begin.size() ? m_closure.row(id) : std::span<const std::uint32_t> { };
+}
+
+/**
+ * Check whether prerequisite has to be taken, directly or not, before course
+ *
+ * @param course A vertex id
+ * @param prerequisite A vertex id
+ */
+bool PrerequisiteGraph::dependsOn(const std::uint32_t &course, const std::uint32_t &prerequisite) const {
+	std::span<const std::uint32_t> needed { closure(course) };
+	return std::binary_search(needed.begin(), needed.end(), prerequisite);
+}
+
+/**
+ * Rebuilt on the first call after update(), so call it once before
+ * sharing an updated graph between threads
+ *
+ * @return Every vertex not on or behind a cycle, each after all of its prerequisites
+ */
+std::span<const std::uint32_t> PrerequisiteGraph::order() const {
+	if (m_order_stale) {
+		// counting sort by term, every course's term is past its prerequisites'
+		std::vector<std::uint32_t> starts;
+		for (std::uint32_t v = 0; v < m_terms.size(); ++v) {
+			if (m_terms[v] != INVALID) {
+				starts.resize(std::max<std::size_t>(starts.size(), m_terms[v] + 2), 0);
+				++starts[m_terms[v] + 1];
+			}
+		}
+		for (std::size_t term = 1; term < starts.size(); ++term) {
+			starts[term] += starts[term - 1];
+		}
+		m_order.resize(starts.empty() ? 0 : starts.back());
+		for (std::uint32_t v = 0; v < m_terms.size(); ++v) {
+			if (m_terms[v] != INVALID) {
+				m_order[starts[m_terms[v]]++] = v;
+			}
+		}
+		m_order_stale = false;
+	}
+	return m_order;
+}
+
+/**
+ * @return Vertices on a prerequisite cycle or requiring one that is, by id
+ */
+std::span<const std::uint32_t> PrerequisiteGraph::cyclic() const {
+	return m_cyclic;
+}
+
+/**
+ * @return Whether the graph has no prerequisite cycles
+ */
+bool PrerequisiteGraph::acyclic() const {
+	return m_cyclic.empty();
+}
+
+/**
+ * Earliest term a course can be taken if every prerequisite is taken as
+ * early as possible: 0 without prerequisites, else one past the latest
+ * term among its prerequisites
+ *
+ * @param id A vertex id
+ * @return The term, INVALID for unknown ids and courses on or behind a cycle
+ */
+std::uint32_t PrerequisiteGraph::term(const std::uint32_t &id) const {
+	return id < m_terms.size() ? m_terms[id] : INVALID;
+}
@@ -0,0 +1,108 @@
+#pragma once
+#include <cstdint>
+#include <span>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "CourseIds.hpp"
+
+/*
+ * Prerequisite dependency graph
+ *
+ * Every course number, including ones only named as prerequisites, is a
+ * vertex with a dense id (CourseIds). Direct prerequisites are stored in
+ * compressed sparse row form: begin and end arrays into one edge array.
+ * build() computes everything the advising queries need once, so each
+ * query afterwards is a lookup:
+ *   prerequisites(id)  direct prerequisites, O(1)
+ *   dependents(id)     courses naming id as a direct prerequisite, O(1)
+ *   closure(id)        every course needed first, transitively, O(1)
+ *   dependsOn(a, b)    whether b is needed before a, O(log k)
+ *   order()            topological order, prerequisites first
+ *   term(id)           earliest term a course can be taken, 0 for none
+ * Courses on a prerequisite cycle, or depending on one, have no place in
+ * the order and are listed by cyclic() instead.
+ *
+ * Closures are memoized in topological order, each one merged from its
+ * direct prerequisites' closures, so building costs the sum of closure
+ * sizes rather than a search per course.
+ *
+ * After build(), courses can be changed with clearPrerequisites() and
+ * addPrerequisite() and the changes applied with update(), which only
+ * recomputes the changed courses and the courses depending on them.
+ * Each row, direct prerequisites, dependents or closure, is a range of
+ * one shared array, so a changed row is appended and repointed; the
+ * arrays are repacked once more than half of them is stale.
+ */
+class PrerequisiteGraph {
+	private:
+		// one row of vertex ids per vertex, row v is data[begin[v], end[v])
+		struct Rows {
+			std::vector<std::uint32_t> begin;
+			std::vector<std::uint32_t> end;
+			std::vector<std::uint32_t> data;
+			std::size_t live { }; // ids in current rows, the rest of data is stale
+			std::span<const std::uint32_t> row(const std::uint32_t &v) const;
+			void layout(const std::size_t &n, std::span<const std::pair<std::uint32_t, std::uint32_t>> edges, const bool &reverse);
+			void assign(const std::uint32_t &v, std::span<const std::uint32_t> ids);
+			void compact();
+		};
+		CourseIds m_ids;
+		std::vector<std::pair<std::uint32_t, std::uint32_t>> m_pending; // (course, prerequisite) until build or update
+		std::vector<std::uint32_t> m_cleared; // courses whose rows update() replaces
+		Rows m_edges; // direct prerequisites, sorted
+		Rows m_dependents; // the reverse, courses naming a vertex as a prerequisite, sorted
+		Rows m_closure; // sorted
+		mutable std::vector<std::uint32_t> m_order;
+		mutable bool m_order_stale { false }; // set by update(), order() rebuilds it by term
+		std::vector<std::uint32_t> m_cyclic;
+		std::vector<std::uint32_t> m_terms;
+		std::vector<std::uint32_t> m_affected; // INVALID, or a vertex's index into update()'s work list
+
+	public:
+		static constexpr std::uint32_t INVALID { CourseIds::INVALID };
+		std::uint32_t addCourse(std::string_view number);
+		void addPrerequisite(const std::uint32_t &course, std::string_view prerequisite);
+		void build();
+		void clearPrerequisites(const std::uint32_t &course);
+		std::size_t update();
+		std::uint32_t id(std::string_view number) const;
+		std::string_view number(const std::uint32_t &id) const;
+		std::size_t size() const;
+		std::span<const std::uint32_t> prerequisites(const std::uint32_t &id) const;
+		std::span<const std::uint32_t> dependents(const std::uint32_t &id) const;
+		std::span<const std::uint32_t> closure(const std::uint32_t &id) const;
+		bool dependsOn(const std::uint32_t &course, const std::uint32_t &prerequisite) const;
+		std::span<const std::uint32_t> order() const;
+		std::span<const std::uint32_t> cyclic() const;
+		bool acyclic() const;
+		std::uint32_t term(const std::uint32_t &id) const;
+};
+
+/*
+ * Build the prerequisite graph of a catalog
+ *
+ * Works with any table providing for_each(fn(const Value &)) over values
+ * with number and prerequisites members. Prerequisites may be course
+ * numbers (Course) or ids into the table's own CourseIds (ArenaCourse).
+ *
+ * @param table The catalog
+ * @return The built graph
+ */
+template <typename Table>
+PrerequisiteGraph BuildPrerequisiteGraph(const Table &table) {
+	PrerequisiteGraph graph;
+	table.for_each([&](const auto &course) {
+		std::uint32_t id { graph.addCourse(course.number) };
+		for (const auto &prerequisite : course.prerequisites) {
+			if constexpr (std::is_integral_v<std::remove_cvref_t<decltype(prerequisite)>>) {
+				graph.addPrerequisite(id, table.ids().number(prerequisite));
+			} else {
+				graph.addPrerequisite(id, prerequisite);
+			}
+		}
+	});
+	graph.build();
+	return graph;
+}
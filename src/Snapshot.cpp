@@ -0,0 +1,355 @@
+#include "Snapshot.hpp"
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <system_error>
+#include <vector>
+#include "CourseIds.hpp"
+#include "Hash.hpp"
+
+using namespace snapshot_detail;
+
+namespace {
+	std::uint64_t align8(const std::uint64_t &offset) {
+		return (offset + 7) & ~std::uint64_t { 7 };
+	}
+
+	// whether count items of size bytes at offset fit in a file of file_size bytes
+	bool fits(const std::uint64_t &offset, const std::uint64_t &count, const std::size_t &size, const std::uint64_t &file_size) {
+		return offset % 4 == 0 && offset <= file_size && count * size <= file_size - offset;
+	}
+}
+
+/**
+ * Read the size and modification time of a file, and optionally hash it
+ *
+ * @param file_path The file
+ * @param stamp Receives the stamp
+ * @param hash_contents Also hash the whole file into stamp.hash
+ * @return false if the file could not be read
+ */
+bool snapshot_detail::StampFile(const std::string &file_path, SourceStamp &stamp, const bool &hash_contents) {
+	std::error_code error;
+	stamp.size = std::filesystem::file_size(file_path, error);
+	if (error) {
+		return false;
+	}
+	stamp.mtime = std::filesystem::last_write_time(file_path, error).time_since_epoch().count();
+	if (error) {
+		return false;
+	}
+	if (hash_contents) {
+		MappedFile file { file_path };
+		if (!file.is_open()) {
+			return false;
+		}
+		stamp.hash = WyHash {}(file.view());
+	}
+	return true;
+}
+
+/**
+ * Map a snapshot, if it is well formed and still matches its source.
+ * Size and modification time are compared first; the source is only
+ * hashed when its time changed, so touching the CSV costs a hash but
+ * not a rebuild.
+ *
+ * @param snapshot_path The snapshot file
+ * @param source_path The CSV it was built from
+ */
+CatalogSnapshot::CatalogSnapshot(const std::string &snapshot_path, const std::string &source_path) : m_file { snapshot_path } {
+	CSC300_TIME(Snapshot);
+	if (!m_file.is_open() || !verify()) {
+		*this = CatalogSnapshot { };
+		return;
+	}
+	SourceStamp stamp;
+	bool fresh { StampFile(source_path, stamp, false) && stamp.size == m_header->source_size };
+	if (fresh && stamp.mtime != m_header->source_mtime) {
+		fresh = StampFile(source_path, stamp, true) && stamp.hash == m_header->source_hash;
+	}
+	if (!fresh) {
+		*this = CatalogSnapshot { };
+	}
+}
+
+/**
+ * Check the header and that every offset and id stays within the file,
+ * then point the section pointers into the mapping
+ *
+ * @return false if the file is not a snapshot this build can read
+ */
+bool CatalogSnapshot::verify() {
+	std::string_view data { m_file.view() };
+	if (data.size() < sizeof(Header) || reinterpret_cast<std::uintptr_t>(data.data()) % 8 != 0) {
+		return false;
+	}
+	const Header *header { reinterpret_cast<const Header *>(data.data()) };
+	if (std::memcmp(header->magic, MAGIC, sizeof(MAGIC)) != 0 || header->version != VERSION || header->byte_order != ORDER_MARK) {
+		return false;
+	}
+	std::uint64_t size { data.size() };
+	if (!fits(header->names_offset, header->number_count, sizeof(Name), size)
+			|| !fits(header->records_offset, header->course_count, sizeof(Record), size)
+			|| !fits(header->prerequisites_offset, header->prerequisite_count, sizeof(std::uint32_t), size)
+			|| !fits(header->pilots_offset, header->pilot_count, sizeof(std::uint32_t), size)
+			|| !fits(header->positions_offset, header->course_count, sizeof(std::uint32_t), size)
+			|| !fits(header->strings_offset, header->strings_size, 1, size)
+			|| header->course_count > header->number_count
+			|| (header->course_count > 0 && header->pilot_count == 0)) {
+		return false;
+	}
+	m_names = reinterpret_cast<const Name *>(data.data() + header->names_offset);
+	m_records = reinterpret_cast<const Record *>(data.data() + header->records_offset);
+	m_prerequisites = reinterpret_cast<const std::uint32_t *>(data.data() + header->prerequisites_offset);
+	m_pilots = reinterpret_cast<const std::uint32_t *>(data.data() + header->pilots_offset);
+	m_positions = reinterpret_cast<const std::uint32_t *>(data.data() + header->positions_offset);
+	m_strings = data.data() + header->strings_offset;
+	// one pass over the integers, so no lookup can read out of bounds
+	for (std::uint32_t i = 0; i < header->number_count; ++i) {
+		if (m_names[i].offset > header->strings_size || m_names[i].size > header->strings_size - m_names[i].offset) {
+			return false;
+		}
+	}
+	for (std::uint32_t i = 0; i < header->course_count; ++i) {
+		const Record &record { m_records[i] };
+		if (record.title_offset > header->strings_size || record.title_size > header->strings_size - record.title_offset
+				|| record.prerequisites_begin > header->prerequisite_count || record.prerequisites_count > header->prerequisite_count - record.prerequisites_begin) {
+			return false;
+		}
+	}
+	for (std::uint32_t i = 0; i < header->prerequisite_count; ++i) {
+		if (m_prerequisites[i] >= header->number_count) {
+			return false;
+		}
+	}
+	for (std::uint32_t i = 0; i < header->course_count; ++i) {
+		if (m_positions[i] >= header->course_count) {
+			return false;
+		}
+	}
+	m_header = header;
+	return true;
+}
+
+/**
+ * @return Whether the snapshot is mapped, valid and fresh
+ */
+bool CatalogSnapshot::is_open() const {
+	return m_header != nullptr;
+}
+
+/**
+ * @return The number of courses
+ */
+std::size_t CatalogSnapshot::size() const {
+	return m_header == nullptr ? 0 : m_header->course_count;
+}
+
+/**
+ * @return The number of rows of the CSV the snapshot was built from
+ */
+std::size_t CatalogSnapshot::row_count() const {
+	return m_header == nullptr ? 0 : m_header->source_rows;
+}
+
+/**
+ * Look up a course number in the prebuilt perfect hash
+ *
+ * @param course_number The course number
+ * @return Its id, CourseIds::INVALID if it is not a course
+ */
+std::uint32_t CatalogSnapshot::id(std::string_view course_number) const {
+	if (size() == 0) {
+		return CourseIds::INVALID;
+	}
+	std::uint32_t found { m_positions[PerfectHash::position(m_header->hash_seed, { m_pilots, m_header->pilot_count }, m_header->course_count, course_number)] };
+	return number(found) == course_number ? found : CourseIds::INVALID;
+}
+
+/**
+ * @return A copy of the perfect hash over the course numbers, empty if not open
+ */
+PerfectHash CatalogSnapshot::perfect_hash() const {
+	if (m_header == nullptr) {
+		return { };
+	}
+	return { m_header->hash_seed, m_header->course_count, { m_pilots, m_pilots + m_header->pilot_count } };
+}
+
+/**
+ * @param position A position of perfect_hash(), below size()
+ * @return The id of the course at that position
+ */
+std::uint32_t CatalogSnapshot::position_id(const std::uint32_t &position) const {
+	return m_positions[position];
+}
+
+/**
+ * @param id A course or prerequisite id
+ * @return Its course number
+ */
+std::string_view CatalogSnapshot::number(const std::uint32_t &id) const {
+	return { m_strings + m_names[id].offset, m_names[id].size };
+}
+
+/**
+ * @param id A course id, below size()
+ * @return A view of the course, pointing into the mapping
+ */
+ArenaCourse CatalogSnapshot::course(const std::uint32_t &id) const {
+	const Record &record { m_records[id] };
+	return { id, number(id), { m_strings + record.title_offset, record.title_size }, { m_prerequisites + record.prerequisites_begin, record.prerequisites_count } };
+}
+
+/**
+ * Search for a course
+ *
+ * @param course_number The course number to search for
+ * @return The course, or an empty course (id INVALID) if it isn't found
+ */
+ArenaCourse CatalogSnapshot::search(std::string_view course_number) const {
+	std::uint32_t found { id(course_number) };
+	return found == CourseIds::INVALID ? ArenaCourse { } : course(found);
+}
+
+/**
+ * @param course_number The course number to search for
+ * @return true if the course is in the snapshot
+ */
+bool CatalogSnapshot::contains(std::string_view course_number) const {
+	return id(course_number) != CourseIds::INVALID;
+}
+
+/**
+ * Copy a course into an owning Course
+ *
+ * @param course A course of this snapshot
+ */
+Course CatalogSnapshot::toCourse(const ArenaCourse &course) const {
+	Course result { std::string { course.number }, std::string { course.title }, { } };
+	result.prerequisites.reserve(course.prerequisites.size());
+	for (std::uint32_t prerequisite : course.prerequisites) {
+		result.prerequisites.emplace_back(number(prerequisite));
+	}
+	return result;
+}
+
+/**
+ * Print a course in the same format as Course's operator<<
+ *
+ * @param os The stream to print to
+ * @param course A course of this snapshot
+ */
+void CatalogSnapshot::print(std::ostream &os, const ArenaCourse &course) const {
+	os << "Number: " << course.number << '\n' << "Title: " << course.title << '\n';
+	os << "Prerequisites: ";
+	for (std::size_t i = 0; i < course.prerequisites.size(); ++i) {
+		os << (i == 0 ? "" : ", ") << number(course.prerequisites[i]);
+	}
+}
+
+/**
+ * Write courses, sorted by number and with unique numbers, as a snapshot
+ *
+ * @param courses The courses in course number order
+ * @param snapshot_path Where to write the snapshot
+ * @param source Stamp of the CSV the courses were loaded from
+ * @return false if the file could not be written
+ */
+bool WriteSnapshot(std::span<const Course *const> courses, const std::string &snapshot_path, const SourceStamp &source) {
+	CSC300_TIME(Snapshot);
+	// courses take ids 0 to n - 1 in order, prerequisite only numbers follow
+	CourseIds ids;
+	ids.reserve(courses.size());
+	for (std::size_t i = 0; i < courses.size(); ++i) {
+		if (ids.intern(courses[i]->number) != i) {
+			return false;
+		}
+	}
+	std::string strings;
+	auto append = [&](std::string_view str) {
+		std::uint32_t offset { static_cast<std::uint32_t>(strings.size()) };
+		strings.append(str);
+		return offset;
+	};
+	std::vector<Record> records;
+	std::vector<std::uint32_t> prerequisites;
+	records.reserve(courses.size());
+	for (const Course *course : courses) {
+		std::uint32_t title { append(course->title) };
+		records.push_back({ title, static_cast<std::uint32_t>(course->title.size()), static_cast<std::uint32_t>(prerequisites.size()), static_cast<std::uint32_t>(course->prerequisites.size()) });
+		for (const std::string &prerequisite : course->prerequisites) {
+			prerequisites.push_back(ids.intern(prerequisite));
+		}
+	}
+	std::vector<Name> names;
+	names.reserve(ids.size());
+	for (std::uint32_t id = 0; id < ids.size(); ++id) {
+		names.push_back({ append(ids.number(id)), static_cast<std::uint32_t>(ids.number(id).size()) });
+	}
+	if (strings.size() > UINT32_MAX || prerequisites.size() > UINT32_MAX) {
+		return false;
+	}
+	PerfectHash hash;
+	std::vector<std::string_view> numbers;
+	numbers.reserve(courses.size());
+	for (const Course *course : courses) {
+		numbers.push_back(course->number);
+	}
+	if (!hash.build(numbers)) {
+		return false;
+	}
+	std::vector<std::uint32_t> positions(courses.size());
+	for (std::uint32_t id = 0; id < courses.size(); ++id) {
+		positions[hash(courses[id]->number)] = id;
+	}
+
+	Header header { };
+	std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+	header.version = VERSION;
+	header.byte_order = ORDER_MARK;
+	header.source_size = source.size;
+	header.source_mtime = source.mtime;
+	header.source_hash = source.hash;
+	header.source_rows = source.rows;
+	header.course_count = static_cast<std::uint32_t>(courses.size());
+	header.number_count = static_cast<std::uint32_t>(names.size());
+	header.prerequisite_count = static_cast<std::uint32_t>(prerequisites.size());
+	header.pilot_count = static_cast<std::uint32_t>(hash.pilots().size());
+	header.hash_seed = hash.seed();
+	header.names_offset = sizeof(Header);
+	header.records_offset = align8(header.names_offset + names.size() * sizeof(Name));
+	header.prerequisites_offset = align8(header.records_offset + records.size() * sizeof(Record));
+	header.pilots_offset = align8(header.prerequisites_offset + prerequisites.size() * sizeof(std::uint32_t));
+	header.positions_offset = align8(header.pilots_offset + hash.pilots().size() * sizeof(std::uint32_t));
+	header.strings_offset = align8(header.positions_offset + positions.size() * sizeof(std::uint32_t));
+	header.strings_size = strings.size();
+
+	std::string temp_path { snapshot_path + ".tmp" };
+	{
+		std::ofstream out { temp_path, std::ios::binary | std::ios::trunc };
+		auto section = [&](const std::uint64_t &offset, const void *data, const std::size_t &bytes) {
+			// zero pad up to the section's aligned offset
+			static constexpr char PADDING[8] { };
+			out.write(PADDING, static_cast<std::streamsize>(offset - static_cast<std::uint64_t>(out.tellp())));
+			out.write(static_cast<const char *>(data), static_cast<std::streamsize>(bytes));
+		};
+		out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+		section(header.names_offset, names.data(), names.size() * sizeof(Name));
+		section(header.records_offset, records.data(), records.size() * sizeof(Record));
+		section(header.prerequisites_offset, prerequisites.data(), prerequisites.size() * sizeof(std::uint32_t));
+		section(header.pilots_offset, hash.pilots().data(), hash.pilots().size() * sizeof(std::uint32_t));
+		section(header.positions_offset, positions.data(), positions.size() * sizeof(std::uint32_t));
+		section(header.strings_offset, strings.data(), strings.size());
+		if (!out) {
+			std::error_code error;
+			std::filesystem::remove(temp_path, error);
+			return false;
+		}
+	}
+	std::error_code error;
+	std::filesystem::rename(temp_path, snapshot_path, error);
+	return !error;
+}
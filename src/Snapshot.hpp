@@ -0,0 +1,217 @@
+#pragma once
+#include <cstdint>
+#include <iostream>
+#include <span>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include "Course.hpp"
+#include "CourseArena.hpp"
+#include "CsvLoader.hpp"
+#include "FrozenTable.hpp"
+#include "HashTable.hpp"
+#include "MappedFile.hpp"
+#include "PerfectHash.hpp"
+#include "Sort.hpp"
+
+/*
+ * Binary catalog snapshot
+ *
+ * A validated catalog written as one position independent file that can
+ * be memory mapped and queried in place: no parsing, no validation and
+ * no per course allocation on startup. Layout, every section 8 byte
+ * aligned and every reference an offset or an id:
+ *   Header          magic, version, source file stamp, section offsets
+ *   Name[]          number of every id: courses first, in course number
+ *                   order, then numbers only named as prerequisites
+ *   Record[]        title and prerequisite range of every course id
+ *   uint32_t[]      prerequisite ids of every course, back to back
+ *   uint32_t[]      pilots of a minimal perfect hash over course numbers
+ *   uint32_t[]      course id at each position of that hash
+ *   char[]          string pool, numbers and titles
+ * A lookup is one perfect hash, one id read and one number compare. The
+ * same hash places the courses of ToFrozenTable, which so needs no build.
+ * The header records the size, modification time and hash of the CSV
+ * the snapshot was built from, and its row count; a snapshot that does
+ * not match its source refuses to open so callers fall back to the CSV.
+ */
+namespace snapshot_detail {
+	constexpr char MAGIC[8] { 'C', 'S', 'C', '3', '0', '0', 'S', 'N' };
+	constexpr std::uint32_t VERSION { 3 };
+	constexpr std::uint32_t ORDER_MARK { 0x01020304 }; // read back differently on a foreign byte order
+
+	struct Header {
+		char magic[8];
+		std::uint32_t version;
+		std::uint32_t byte_order;
+		std::uint64_t source_size;
+		std::int64_t source_mtime;
+		std::uint64_t source_hash;
+		std::uint64_t source_rows;
+		std::uint32_t course_count;
+		std::uint32_t number_count;
+		std::uint32_t prerequisite_count;
+		std::uint32_t pilot_count;
+		std::uint64_t names_offset;
+		std::uint64_t records_offset;
+		std::uint64_t prerequisites_offset;
+		std::uint64_t pilots_offset;
+		std::uint64_t positions_offset; // course_count ids
+		std::uint64_t strings_offset;
+		std::uint64_t strings_size;
+		std::uint64_t hash_seed;
+	};
+	struct Name {
+		std::uint32_t offset; // into the string pool
+		std::uint32_t size;
+	};
+	struct Record {
+		std::uint32_t title_offset;
+		std::uint32_t title_size;
+		std::uint32_t prerequisites_begin;
+		std::uint32_t prerequisites_count;
+	};
+	static_assert(sizeof(Header) % 8 == 0 && std::is_trivially_copyable_v<Header>);
+
+	// size, modification time and content hash of a source file, and
+	// the rows loaded from it
+	struct SourceStamp {
+		std::uint64_t size { };
+		std::int64_t mtime { };
+		std::uint64_t hash { };
+		std::uint64_t rows { }; // not read by StampFile
+	};
+	bool StampFile(const std::string &file_path, SourceStamp &stamp, const bool &hash_contents);
+}
+
+/*
+ * Read only catalog served straight from a mapped snapshot file.
+ * Course ids are positions in course number order, so for_each visits
+ * courses in order. Records are ArenaCourse views into the mapping.
+ */
+class CatalogSnapshot {
+	private:
+		MappedFile m_file;
+		const snapshot_detail::Header *m_header { nullptr };
+		const snapshot_detail::Name *m_names { nullptr };
+		const snapshot_detail::Record *m_records { nullptr };
+		const std::uint32_t *m_prerequisites { nullptr };
+		const std::uint32_t *m_pilots { nullptr };
+		const std::uint32_t *m_positions { nullptr };
+		const char *m_strings { nullptr };
+		bool verify();
+
+	public:
+		CatalogSnapshot() = default;
+		CatalogSnapshot(const std::string &snapshot_path, const std::string &source_path);
+		bool is_open() const;
+		std::size_t size() const;
+		std::size_t row_count() const;
+		std::uint32_t id(std::string_view course_number) const;
+		std::string_view number(const std::uint32_t &id) const;
+		ArenaCourse course(const std::uint32_t &id) const;
+		ArenaCourse search(std::string_view course_number) const;
+		bool contains(std::string_view course_number) const;
+		template <typename F>
+		void for_each(F &&fn) const;
+		Course toCourse(const ArenaCourse &course) const;
+		void print(std::ostream &os, const ArenaCourse &course) const;
+		PerfectHash perfect_hash() const;
+		std::uint32_t position_id(const std::uint32_t &position) const;
+};
+
+/**
+ * Call fn(const ArenaCourse &) for every course, in course number order
+ *
+ * @param fn The function to call
+ */
+template <typename F>
+void CatalogSnapshot::for_each(F &&fn) const {
+	for (std::uint32_t id = 0; id < size(); ++id) {
+		fn(static_cast<const ArenaCourse &>(course(id)));
+	}
+}
+
+bool WriteSnapshot(std::span<const Course *const> courses, const std::string &snapshot_path, const snapshot_detail::SourceStamp &source);
+
+/*
+ * Write a catalog as a snapshot of the CSV it was loaded from.
+ * Writes to a temporary file and renames it, so readers never see a
+ * partial snapshot.
+ *
+ * @param table Any table of Courses with for_each
+ * @param snapshot_path Where to write the snapshot
+ * @param source Stamp of the CSV as the table was loaded from it, the
+ * hash taken from the parsed bytes (see LoadOptions::hash_source)
+ * @return false if the file could not be written
+ */
+template <typename Table>
+bool WriteSnapshot(const Table &table, const std::string &snapshot_path, const snapshot_detail::SourceStamp &source) {
+	std::vector<const Course *> courses { SortCourses(table) };
+	return WriteSnapshot(std::span<const Course *const> { courses }, snapshot_path, source);
+}
+
+/*
+ * Copy a snapshot into a hash table, no parsing or validation needed
+ *
+ * @param snapshot An open snapshot
+ * @return The table
+ */
+template <typename Hash = WyHash>
+HashTable<Hash> ToHashTable(const CatalogSnapshot &snapshot) {
+	CSC300_TIME(Snapshot);
+	HashTable<Hash> table;
+	table.reserve(snapshot.size());
+	snapshot.for_each([&](const ArenaCourse &course) {
+		table.insert(snapshot.toCourse(course));
+	});
+	return table;
+}
+
+/*
+ * Copy a snapshot into a frozen table, placed by the snapshot's own
+ * perfect hash so no hash is built
+ *
+ * @param snapshot An open snapshot
+ * @return The table
+ */
+inline FrozenTable<Course> ToFrozenTable(const CatalogSnapshot &snapshot) {
+	CSC300_TIME(Snapshot);
+	std::vector<Course> courses;
+	courses.reserve(snapshot.size());
+	for (std::uint32_t position = 0; position < snapshot.size(); ++position) {
+		courses.push_back(snapshot.toCourse(snapshot.course(snapshot.position_id(position))));
+	}
+	return { snapshot.perfect_hash(), std::move(courses) };
+}
+
+/*
+ * Load a catalog from its snapshot when the snapshot is fresh, otherwise
+ * from the CSV, refreshing the snapshot after a clean load. The snapshot
+ * is only a cache: a failed write just means parsing next time. It is
+ * stamped with the hash of the bytes actually parsed, and not written
+ * at all if the CSV's size or time changed during the load.
+ *
+ * @param file_path Path to the CSV; the snapshot is file_path + ".snapshot"
+ * @param options Thread count for parsing the CSV
+ * @return The loaded table, the number of rows and all errors found
+ */
+template <typename Hash = WyHash>
+LoadResult<HashTable<Hash>> LoadCatalogCached(const std::string &file_path, const LoadOptions &options = { }) {
+	std::string snapshot_path { file_path + ".snapshot" };
+	CatalogSnapshot snapshot { snapshot_path, file_path };
+	if (snapshot.is_open()) {
+		return { ToHashTable<Hash>(snapshot), static_cast<int>(snapshot.row_count()), { }, true };
+	}
+	snapshot_detail::SourceStamp before, after;
+	bool stamped { snapshot_detail::StampFile(file_path, before, false) };
+	LoadOptions hashed { options };
+	hashed.hash_source = true;
+	LoadResult<HashTable<Hash>> result { LoadCatalog<Hash>(file_path, hashed) };
+	if (result.ok() && stamped && snapshot_detail::StampFile(file_path, after, false) && after.size == before.size && after.mtime == before.mtime) {
+		before.hash = result.source_hash;
+		before.rows = static_cast<std::uint64_t>(result.row_count);
+		WriteSnapshot(result.table, snapshot_path, before);
+	}
+	return result;
+}
@@ -0,0 +1,230 @@
+#include "Sort.hpp"
+#include <algorithm>
+#include <bit>
+#include "Parallel.hpp"
+
+namespace {
+	// ranges this small are insertion sorted
+	constexpr std::ptrdiff_t SMALL_RANGE { 16 };
+	// ParallelSort sorts inputs smaller than this on the calling thread
+	constexpr std::size_t PARALLEL_THRESHOLD { 1 << 16 };
+
+	inline bool less(const SortEntry &a, const SortEntry &b) {
+		if (a.prefix != b.prefix) {
+			return a.prefix < b.prefix;
+		}
+		return a.key < b.key;
+	}
+
+	void insertionSort(SortEntry *first, SortEntry *last) {
+		for (SortEntry *i { first + 1 }; i < last; ++i) {
+			SortEntry entry { *i };
+			SortEntry *j { i };
+			for (; j > first && less(entry, *(j - 1)); --j) {
+				*j = *(j - 1);
+			}
+			*j = entry;
+		}
+	}
+
+	// order *a, *b, *c so that *b is their median
+	void sortThree(SortEntry *a, SortEntry *b, SortEntry *c) {
+		if (less(*b, *a)) {
+			std::swap(*a, *b);
+		}
+		if (less(*c, *b)) {
+			std::swap(*b, *c);
+			if (less(*b, *a)) {
+				std::swap(*a, *b);
+			}
+		}
+	}
+
+	void introSort(SortEntry *first, SortEntry *last, int depth) {
+		while (last - first > SMALL_RANGE) {
+			// too many bad pivots: finish this range with heapsort
+			if (depth-- == 0) {
+				std::make_heap(first, last, less);
+				std::sort_heap(first, last, less);
+				return;
+			}
+			SortEntry *mid { first + (last - first) / 2 };
+			sortThree(first, mid, last - 1);
+			SortEntry pivot { *mid };
+			// Hoare partition; first and last - 1 already bound the scans
+			SortEntry *low { first };
+			SortEntry *high { last - 1 };
+			while (true) {
+				do {
+					++low;
+				} while (less(*low, pivot));
+				do {
+					--high;
+				} while (less(pivot, *high));
+				if (low >= high) {
+					break;
+				}
+				std::swap(*low, *high);
+			}
+			// recurse into the smaller side, loop on the larger so the stack stays O(log n)
+			if (high + 1 - first < last - (high + 1)) {
+				introSort(first, high + 1, depth);
+				first = high + 1;
+			} else {
+				introSort(high + 1, last, depth);
+				last = high + 1;
+			}
+		}
+		insertionSort(first, last);
+	}
+}
+
+/**
+ * Build a sort entry for a key
+ *
+ * @param key The key, must outlive the entry
+ * @param index Position of the item the key belongs to
+ */
+SortEntry MakeSortEntry(std::string_view key, const std::uint32_t &index) {
+	std::uint64_t prefix { };
+	for (std::size_t i = 0; i < 8; ++i) {
+		prefix <<= 8;
+		if (i < key.size()) {
+			prefix |= static_cast<unsigned char>(key[i]);
+		}
+	}
+	return { prefix, key, index };
+}
+
+/**
+ * Sort entries by key on the calling thread
+ *
+ * @param entries The entries to sort
+ */
+void IntroSort(std::span<SortEntry> entries) {
+	if (entries.size() < 2) {
+		return;
+	}
+	int depth { 2 * static_cast<int>(std::bit_width(entries.size())) };
+	introSort(entries.data(), entries.data() + entries.size(), depth);
+}
+
+/**
+ * Sort entries by key using up to threads threads.
+ * Each thread introsorts one run, then runs are merged pairwise,
+ * with the merges of each round running concurrently.
+ *
+ * @param entries The entries to sort
+ * @param threads The maximum number of threads
+ */
+void ParallelSort(std::span<SortEntry> entries, const unsigned int &threads) {
+	if (threads <= 1 || entries.size() < PARALLEL_THRESHOLD) {
+		IntroSort(entries);
+		return;
+	}
+	std::size_t runs { std::min<std::size_t>(threads, entries.size() / (PARALLEL_THRESHOLD / 4)) };
+	std::vector<std::size_t> bounds;
+	for (std::size_t r = 0; r <= runs; ++r) {
+		bounds.push_back(entries.size() * r / runs);
+	}
+	ParallelFor(runs, threads, [&](std::size_t r) {
+		IntroSort(entries.subspan(bounds[r], bounds[r + 1] - bounds[r]));
+	});
+	// merge neighbouring runs until one is left, ping-ponging through a buffer
+	std::vector<SortEntry> buffer(entries.size());
+	std::span<SortEntry> from { entries }, to { buffer };
+	while (bounds.size() > 2) {
+		std::size_t pairs { (bounds.size() - 1) / 2 };
+		ParallelFor((bounds.size()) / 2, threads, [&](std::size_t p) {
+			std::size_t begin { bounds[2 * p] };
+			if (p < pairs) {
+				std::size_t mid { bounds[2 * p + 1] }, end { bounds[2 * p + 2] };
+				std::merge(from.begin() + begin, from.begin() + mid, from.begin() + mid, from.begin() + end, to.begin() + begin, less);
+			} else {
+				// odd run out, carried over to the next round
+				std::copy(from.begin() + begin, from.begin() + bounds.back(), to.begin() + begin);
+			}
+		});
+		std::vector<std::size_t> merged;
+		for (std::size_t b = 0; b < bounds.size(); b += 2) {
+			merged.push_back(bounds[b]);
+		}
+		if (merged.back() != bounds.back()) {
+			merged.push_back(bounds.back());
+		}
+		bounds = std::move(merged);
+		std::swap(from, to);
+	}
+	if (from.data() != entries.data()) {
+		std::copy(from.begin(), from.end(), entries.begin());
+	}
+}
+
+/**
+ * Get the first key after every key starting with prefix, so that
+ * [prefix, PrefixSuccessor(prefix)) holds exactly the keys with the prefix
+ *
+ * @param prefix The prefix
+ * @return The successor, empty if there is none (prefix is all 0xff bytes)
+ */
+std::string PrefixSuccessor(std::string_view prefix) {
+	std::string last { prefix };
+	while (!last.empty() && static_cast<unsigned char>(last.back()) == 0xff) {
+		last.pop_back();
+	}
+	if (!last.empty()) {
+		last.back() = static_cast<char>(static_cast<unsigned char>(last.back()) + 1);
+	}
+	return last;
+}
+
+/**
+ * The original course sort: an in place quicksort of whole courses with a
+ * middle pivot. Kept as the baseline SortCourses is measured against; it
+ * copies every course it swaps and is O(n^2) on adversarial input.
+ *
+ * @param courses The courses to sort by number
+ * @param lowIndex First index of the range to sort
+ * @param highIndex Last index of the range to sort, inclusive
+ */
+void Quicksort(std::vector<Course> *courses, int lowIndex, int highIndex) {
+	auto partition = [courses](int low, int high) -> int {
+		// Pick middle element as pivot
+		int midpoint = low + (high - low) / 2;
+		std::string pivot = courses->at(midpoint).number;
+		bool done = false;
+		while (!done) {
+			// Increment lowIndex while courses.at(lowIndex) < pivot
+			while (courses->at(low).number.compare(pivot) < 0) {
+				low += 1;
+			}
+			// Decrement highIndex while pivot < courses.at(highIndex)
+			while (pivot.compare(courses->at(high).number) < 0) {
+				high -= 1;
+			}
+			// If zero or one elements remain, then all numbers are partitioned. retun highIndex
+			if (low >= high) {
+				done = true;
+			} else {
+				// Swap low and high
+				Course temp = courses->at(low);
+				courses->at(low) = courses->at(high);
+				courses->at(high) = temp;
+				// Update lowIndex and highIndex
+				low += 1;
+				high -= 1;
+			}
+		}
+		return high;
+	};
+	// Base case: if the partition size is 1 or zero elements, then the partition is already sorted
+	if (lowIndex >= highIndex) {
+		return;
+	}
+	// Partition the data within the array. Value lowEndIndex returned from partitioning is the index of hte low partition's last element.
+	int lowEndIndex = partition(lowIndex, highIndex);
+	// Recursively sort low partition (lowIndex to lowEndIndex)
+	// and high partition (lowEndIndex + 1 to highIndex)
+	Quicksort(courses, lowIndex, lowEndIndex);
+	Quicksort(courses, lowEndIndex + 1, highIndex);
+}
@@ -0,0 +1,62 @@
+#pragma once
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+#include "Course.hpp"
+#include "Stats.hpp"
+
+/*
+ * Sort engine for ordered course listings
+ *
+ * Sorts lightweight (key, index) entries instead of whole courses. Each
+ * entry caches the first 8 bytes of its key as a big endian integer, so
+ * most comparisons of short course numbers are a single integer compare.
+ * IntroSort is a median-of-three quicksort that falls back to heapsort
+ * past a 2 log2(n) depth limit and to insertion sort for small ranges,
+ * so it is O(n log n) on any input, including sorted and adversarial
+ * ones. ParallelSort introsorts one run per thread and merges the runs.
+ */
+
+struct SortEntry {
+	std::uint64_t prefix; // first 8 bytes of key, big endian, zero padded
+	std::string_view key;
+	std::uint32_t index; // position of the item the key belongs to
+};
+
+SortEntry MakeSortEntry(std::string_view key, const std::uint32_t &index);
+void IntroSort(std::span<SortEntry> entries);
+void ParallelSort(std::span<SortEntry> entries, const unsigned int &threads);
+std::string PrefixSuccessor(std::string_view prefix);
+void Quicksort(std::vector<Course> *courses, int lowIndex, int highIndex);
+
+/*
+ * Get every course of a table ordered by course number
+ *
+ * Works with any table providing for_each(fn(const Value &)) over
+ * values with a number member. Nothing is copied but the keys' views.
+ *
+ * @param table The table to list
+ * @param threads Threads for sorting large tables, see ParallelSort
+ * @return Pointers to the table's courses, valid until the table changes
+ */
+template <typename Table>
+auto SortCourses(const Table &table, const unsigned int &threads = 1) {
+	CSC300_TIME(Sort);
+	using Value = std::remove_cvref_t<decltype(*table.find(std::string_view { }))>;
+	std::vector<const Value *> courses;
+	std::vector<SortEntry> entries;
+	table.for_each([&](const Value &course) {
+		entries.push_back(MakeSortEntry(course.number, static_cast<std::uint32_t>(courses.size())));
+		courses.push_back(&course);
+	});
+	ParallelSort(entries, threads);
+	std::vector<const Value *> sorted;
+	sorted.reserve(courses.size());
+	for (const SortEntry &entry : entries) {
+		sorted.push_back(courses[entry.index]);
+	}
+	return sorted;
+}
@@ -0,0 +1,159 @@
+#include "Stats.hpp"
+#include <algorithm>
+#include <mutex>
+#include <vector>
+
+namespace {
+	std::mutex g_mutex; // guards g_threads and g_retired
+	std::vector<stats_detail::ThreadStats *> g_threads;
+	StatsReport g_retired; // counts of threads that have exited
+	std::array<std::atomic<std::uint64_t>, STAT_PHASES> g_phase_ns { };
+	std::array<std::atomic<std::uint64_t>, STAT_PHASES> g_phase_runs { };
+	// counts made while a thread is exiting land here and are dropped
+	stats_detail::ThreadStats g_discard;
+
+	void retire(stats_detail::ThreadStats *stats) {
+		std::lock_guard<std::mutex> lock { g_mutex };
+		for (std::size_t i = 0; i < STAT_COUNTERS; ++i) {
+			g_retired.counters[i] += stats->counters[i].load(std::memory_order_relaxed);
+		}
+		for (std::size_t i = 0; i < PROBE_BUCKETS; ++i) {
+			g_retired.probes[i] += stats->probes[i].load(std::memory_order_relaxed);
+		}
+		g_threads.erase(std::find(g_threads.begin(), g_threads.end(), stats));
+		delete stats;
+	}
+
+	// folds the thread's counts into g_retired when the thread exits
+	struct Registration {
+		stats_detail::ThreadStats *stats { nullptr };
+		~Registration() {
+			if (stats != nullptr) {
+				stats_detail::t_stats = &g_discard;
+				retire(stats);
+			}
+		}
+	};
+
+	thread_local Registration t_registration;
+}
+
+/**
+ * @param counter A counter
+ * @return Its name, as printed by the stats command
+ */
+const char *StatName(const StatCounter &counter) {
+	switch (counter) {
+	case StatCounter::Lookups: return "lookups";
+	case StatCounter::Misses: return "misses";
+	case StatCounter::Inserts: return "inserts";
+	case StatCounter::Removes: return "removes";
+	case StatCounter::Grows: return "grows";
+	case StatCounter::Shrinks: return "shrinks";
+	default: return "unknown";
+	}
+}
+
+/**
+ * @param phase A phase
+ * @return Its name, as printed by the stats command
+ */
+const char *StatName(const StatPhase &phase) {
+	switch (phase) {
+	case StatPhase::Load: return "load";
+	case StatPhase::Validate: return "validate";
+	case StatPhase::Sort: return "sort";
+	case StatPhase::Snapshot: return "snapshot";
+	case StatPhase::Delta: return "delta";
+	default: return "unknown";
+	}
+}
+
+/**
+ * @return The mean number of slots probed past home per key search
+ */
+double StatsReport::meanProbe() const {
+	std::uint64_t searches { }, probed { };
+	for (std::size_t i = 0; i < PROBE_BUCKETS; ++i) {
+		searches += probes[i];
+		probed += probes[i] * i;
+	}
+	return searches == 0 ? 0 : static_cast<double>(probed) / searches;
+}
+
+/**
+ * Sum the counts of every thread, running or finished. Counts of
+ * running threads are read as they are being written, so the sum may
+ * be a few operations behind.
+ *
+ * @return The counts and phase times so far
+ */
+StatsReport CollectStats() {
+	StatsReport report;
+	{
+		std::lock_guard<std::mutex> lock { g_mutex };
+		report = g_retired;
+		for (const stats_detail::ThreadStats *stats : g_threads) {
+			for (std::size_t i = 0; i < STAT_COUNTERS; ++i) {
+				report.counters[i] += stats->counters[i].load(std::memory_order_relaxed);
+			}
+			for (std::size_t i = 0; i < PROBE_BUCKETS; ++i) {
+				report.probes[i] += stats->probes[i].load(std::memory_order_relaxed);
+			}
+		}
+	}
+	for (std::size_t i = 0; i < STAT_PHASES; ++i) {
+		report.phase_ns[i] = g_phase_ns[i].load(std::memory_order_relaxed);
+		report.phase_runs[i] = g_phase_runs[i].load(std::memory_order_relaxed);
+	}
+#ifdef CSC300_STATS
+	report.enabled = true;
+#endif
+	return report;
+}
+
+/**
+ * Zero every count and phase time. Counts made by other threads at the
+ * same moment may survive the reset.
+ */
+void ResetStats() {
+	std::lock_guard<std::mutex> lock { g_mutex };
+	g_retired = StatsReport { };
+	for (stats_detail::ThreadStats *stats : g_threads) {
+		for (std::atomic<std::uint64_t> &counter : stats->counters) {
+			counter.store(0, std::memory_order_relaxed);
+		}
+		for (std::atomic<std::uint64_t> &bucket : stats->probes) {
+			bucket.store(0, std::memory_order_relaxed);
+		}
+	}
+	for (std::size_t i = 0; i < STAT_PHASES; ++i) {
+		g_phase_ns[i].store(0, std::memory_order_relaxed);
+		g_phase_runs[i].store(0, std::memory_order_relaxed);
+	}
+}
+
+/**
+ * Give the calling thread its counter block, on its first count
+ *
+ * @return The thread's block
+ */
+stats_detail::ThreadStats *stats_detail::Register() {
+	ThreadStats *stats { new ThreadStats { } };
+	{
+		std::lock_guard<std::mutex> lock { g_mutex };
+		g_threads.push_back(stats);
+	}
+	t_registration.stats = stats;
+	t_stats = stats;
+	return stats;
+}
+
+/**
+ * @param phase The phase that ran
+ * @param ns How long it ran
+ */
+void stats_detail::AddPhase(const StatPhase &phase, const std::uint64_t &ns) {
+	g_phase_ns[static_cast<std::size_t>(phase)].fetch_add(ns, std::memory_order_relaxed);
+	g_phase_runs[static_cast<std::size_t>(phase)].fetch_add(1, std::memory_order_relaxed);
+}
@@ -0,0 +1,123 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+/*
+ * Hot path counters, a probe length histogram and phase timers
+ *
+ * Counters are per thread: each thread owns a block of relaxed atomics
+ * that only it writes, so counting is a plain load and store with no
+ * shared cache lines, and CollectStats() sums every thread's block.
+ * Blocks of finished threads are folded into a shared total.
+ * ScopedTimer adds the time until it goes out of scope to a phase, for
+ * coarse phases such as a whole load or sort.
+ *
+ * Code is instrumented through the CSC300_COUNT, CSC300_PROBES and
+ * CSC300_TIME macros. Configuring with -DCSC300_STATS=OFF defines them
+ * to nothing, so there is no cost at all; CollectStats() then reports
+ * enabled as false.
+ */
+enum class StatCounter : unsigned int {
+	Lookups, // find, contains, search and search_batch keys
+	Misses, // lookups that found nothing
+	Inserts,
+	Removes,
+	Grows, // incremental rehashes started
+	Shrinks, // compactions after removals
+	COUNT
+};
+
+enum class StatPhase : unsigned int {
+	Load,
+	Validate,
+	Sort,
+	Snapshot,
+	Delta,
+	COUNT
+};
+
+constexpr std::size_t STAT_COUNTERS { static_cast<std::size_t>(StatCounter::COUNT) };
+constexpr std::size_t STAT_PHASES { static_cast<std::size_t>(StatPhase::COUNT) };
+constexpr std::size_t PROBE_BUCKETS { 17 }; // probe lengths 0 to 15, then 16 or more
+
+const char *StatName(const StatCounter &counter);
+const char *StatName(const StatPhase &phase);
+
+/*
+ * Everything counted so far, summed over threads
+ */
+struct StatsReport {
+	bool enabled { false }; // false when built with CSC300_STATS=OFF
+	std::array<std::uint64_t, STAT_COUNTERS> counters { };
+	std::array<std::uint64_t, PROBE_BUCKETS> probes { }; // key searches by slots probed past home
+	std::array<std::uint64_t, STAT_PHASES> phase_ns { };
+	std::array<std::uint64_t, STAT_PHASES> phase_runs { };
+	std::uint64_t counter(const StatCounter &counter) const { return counters[static_cast<std::size_t>(counter)]; }
+	double meanProbe() const;
+};
+
+StatsReport CollectStats();
+void ResetStats();
+
+namespace stats_detail {
+	struct alignas(64) ThreadStats {
+		std::array<std::atomic<std::uint64_t>, STAT_COUNTERS> counters { };
+		std::array<std::atomic<std::uint64_t>, PROBE_BUCKETS> probes { };
+	};
+
+	inline thread_local ThreadStats *t_stats { nullptr };
+	ThreadStats *Register();
+
+	// only the owning thread writes, so no read-modify-write is needed
+	inline void Bump(std::atomic<std::uint64_t> &value) {
+		value.store(value.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+	}
+
+	inline ThreadStats &Local() {
+		ThreadStats *stats { t_stats };
+		return stats != nullptr ? *stats : *Register();
+	}
+
+	inline void Count(const StatCounter &counter) {
+		Bump(Local().counters[static_cast<std::size_t>(counter)]);
+	}
+
+	inline void Probes(const unsigned int &length) {
+		Bump(Local().probes[length < PROBE_BUCKETS - 1 ? length : PROBE_BUCKETS - 1]);
+	}
+
+	void AddPhase(const StatPhase &phase, const std::uint64_t &ns);
+}
+
+/*
+ * Adds the time from construction to destruction to a phase
+ */
+class ScopedTimer {
+	private:
+		StatPhase m_phase;
+		std::chrono::steady_clock::time_point m_start;
+
+	public:
+		ScopedTimer(const StatPhase &t_phase) : m_phase { t_phase }, m_start { std::chrono::steady_clock::now() } { }
+		ScopedTimer(const ScopedTimer &) = delete;
+		ScopedTimer &operator=(const ScopedTimer &) = delete;
+		~ScopedTimer() {
+			std::chrono::nanoseconds elapsed { std::chrono::steady_clock::now() - m_start };
+			stats_detail::AddPhase(m_phase, static_cast<std::uint64_t>(elapsed.count()));
+		}
+};
+
+#define CSC300_STATS_JOIN2(a, b) a##b
+#define CSC300_STATS_JOIN(a, b) CSC300_STATS_JOIN2(a, b)
+#ifdef CSC300_STATS
+#define CSC300_COUNT(counter) stats_detail::Count(StatCounter::counter)
+#define CSC300_PROBES(length) stats_detail::Probes(length)
+#define CSC300_TIME(phase) ScopedTimer CSC300_STATS_JOIN(csc300_timer_, __LINE__) { StatPhase::phase }
+#else
+#define CSC300_COUNT(counter) ((void)0)
+#define CSC300_PROBES(length) ((void)0)
+#define CSC300_TIME(phase) ((void)0)
+#endif